@@ -0,0 +1,543 @@
+// bench.cpp
+// Author: Owen Kirchner
+// Micro-benchmarks for the hand containers: the plain BST (CardList as
+// built from the file), the same tree after rebalance(), the splay tree and
+// std::set. Workloads are whole games on random deals (cards in shuffled and
+// in sorted file order); recorded game traces (the find/erase sequence
+// playGame issued on the sample hand files and on random deals) replayed
+// against each container; and lookup streams with skewed key popularity.
+// Then whole batches of mask deals through the deal kernels, and last,
+// batched interleaved lookups (probe_batch.h) against one-at-a-time
+// lookups on a tree far bigger than the last-level cache.
+// Build with `make bench`; optional argument: the random seed.
+
+#include "card.h"
+#include "card_list.h"
+#include "deal_kernel.h"
+#include "play_game.h"
+#include "probe_batch.h"
+#include "splay_card_list.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+namespace {
+
+constexpr size_t GAME_BATCH = 1000;   // deals built before each timed batch
+constexpr size_t GAME_BATCHES = 50;
+constexpr size_t LOOKUPS = 2000000;
+constexpr size_t KERNEL_DEALS = 1 << 20;
+constexpr size_t KERNEL_TREE_DEALS = 1 << 16; // CardList games are far slower
+constexpr size_t BIG_TREE_NODES = 1 << 23;     // ~320 MB of nodes, well past the LLC
+constexpr size_t BIG_TREE_PROBES = 1 << 22;
+
+struct Deal {
+  vector<Card> alice;
+  vector<Card> bob;
+};
+
+// every card goes to Alice, Bob, both or neither with equal odds
+Deal randomDeal(mt19937_64& rng, bool sorted) {
+  Deal d;
+  for (int i = 0; i < 52; ++i) {
+    unsigned r = rng() & 3;
+    if (r & 1) d.alice.push_back(cardFromIndex(i));
+    if (r & 2) d.bob.push_back(cardFromIndex(i));
+  }
+  if (!sorted) {
+    shuffle(d.alice.begin(), d.alice.end(), rng);
+    shuffle(d.bob.begin(), d.bob.end(), rng);
+  }
+  return d;
+}
+
+// hand builders: insert in the given order, like main.cpp reads a file
+template <typename Hand>
+void build(Hand& hand, const vector<Card>& cards) {
+  typename Hand::iterator hint = hand.end();
+  for (const Card& c : cards) hint = hand.insert(hint, c);
+}
+
+void build(set<Card>& hand, const vector<Card>& cards) {
+  hand.insert(cards.begin(), cards.end());
+}
+
+// std::set version of the resumable game loop in play_game.h
+void playSetGame(set<Card>& alice, set<Card>& bob, vector<Card>& moves) {
+  auto a = alice.begin();
+  auto b = bob.rbegin();
+  // b refers to *prev(b.base()): erasing that card moves b down by itself.
+  // Cards above it had no match in Alice's hand, so b.base() is never erased.
+  while (true) {
+    auto match = bob.end();
+    while (a != alice.end() && (match = bob.find(*a)) == bob.end()) ++a;
+    if (a == alice.end()) break;
+    moves.push_back(*a);
+    bob.erase(match);
+    a = alice.erase(a);
+
+    auto found = alice.end();
+    while (b != bob.rend() && (found = alice.find(*b)) == alice.end()) ++b;
+    if (b == bob.rend()) break;
+    moves.push_back(*b);
+    if (found == a) a = alice.erase(a);
+    else alice.erase(found);
+    bob.erase(next(b).base());
+  }
+}
+
+// hand file in main.cpp's format ("s 10", "h q", ...), in file order
+vector<Card> loadHand(const string& path) {
+  vector<Card> cards;
+  ifstream in(path);
+  string suit, rank;
+  while (in >> suit >> rank) cards.push_back(Card(suit[0], rank == "10" ? 't' : rank[0]));
+  return cards;
+}
+
+// one hand operation playGame issued: a lookup or an erase in one hand
+struct TraceOp {
+  int hand; // 0 Alice, 1 Bob
+  bool erase;
+  Card card;
+};
+
+// CardList that logs every find and erase playHands makes on it
+class RecordingHand {
+public:
+  using iterator = CardList::iterator;
+  RecordingHand(const vector<Card>& cards, int id, vector<TraceOp>& ops) : id(id), ops(ops) {
+    for (const Card& c : cards) hand.insert(c);
+  }
+  iterator begin() const { return hand.begin(); }
+  iterator end() const { return hand.end(); }
+  iterator rbegin() const { return hand.rbegin(); }
+  iterator rend() const { return hand.rend(); }
+  iterator find(const Card& card) const {
+    ops.push_back(TraceOp{id, false, card});
+    return hand.find(card);
+  }
+  iterator erase(iterator pos) {
+    ops.push_back(TraceOp{id, true, *pos});
+    return hand.erase(pos);
+  }
+
+private:
+  CardList hand;
+  int id;
+  vector<TraceOp>& ops;
+};
+
+vector<TraceOp> recordTrace(const vector<Card>& alice, const vector<Card>& bob) {
+  vector<TraceOp> ops;
+  RecordingHand a(alice, 0, ops), b(bob, 1, ops);
+  vector<Card> moves;
+  playHands(a, b, moves);
+  return ops;
+}
+
+enum class Kind { BST, BALANCED, SPLAY, STD_SET };
+const char* const KIND_NAMES[] = {"bst", "balanced bst", "splay", "std::set"};
+constexpr Kind KINDS[] = {Kind::BST, Kind::BALANCED, Kind::SPLAY, Kind::STD_SET};
+
+void playDeal(Kind kind, const Deal& d, vector<Card>& moves) {
+  switch (kind) {
+  case Kind::BST:
+  case Kind::BALANCED: {
+    CardList alice, bob;
+    build(alice, d.alice);
+    build(bob, d.bob);
+    if (kind == Kind::BALANCED) {
+      alice.rebalance();
+      bob.rebalance();
+    }
+    playGame(alice, bob, moves);
+    break;
+  }
+  case Kind::SPLAY: {
+    SplayCardList alice, bob;
+    build(alice, d.alice);
+    build(bob, d.bob);
+    playGame(alice, bob, moves);
+    break;
+  }
+  case Kind::STD_SET: {
+    set<Card> alice, bob;
+    build(alice, d.alice);
+    build(bob, d.bob);
+    playSetGame(alice, bob, moves);
+    break;
+  }
+  }
+}
+
+// ns per game, building included; every container must agree on the moves
+void benchGames(const char* label, bool sorted, uint64_t seed) {
+  cout << label << endl;
+  uint64_t reference = 0;
+  for (Kind kind : KINDS) {
+    mt19937_64 rng(seed);
+    Clock::duration total{};
+    uint64_t checksum = 0;
+    vector<Deal> deals;
+    vector<Card> moves;
+    for (size_t batch = 0; batch < GAME_BATCHES; ++batch) {
+      deals.clear();
+      for (size_t i = 0; i < GAME_BATCH; ++i) deals.push_back(randomDeal(rng, sorted));
+      Clock::time_point begin = Clock::now();
+      for (const Deal& d : deals) {
+        moves.clear();
+        playDeal(kind, d, moves);
+        for (const Card& c : moves) checksum = checksum * 31 + cardIndex(c) + 1;
+      }
+      total += Clock::now() - begin;
+    }
+    if (kind == KINDS[0]) reference = checksum;
+    double ns = chrono::duration<double, nano>(total).count() / (GAME_BATCH * GAME_BATCHES);
+    cout << "  " << left << setw(14) << KIND_NAMES[static_cast<int>(kind)] << right
+         << fixed << setprecision(0) << setw(10) << ns << " ns/game"
+         << (checksum == reference ? "" : "  MISMATCH") << endl;
+  }
+}
+
+struct Trace {
+  vector<Card> hands[2];
+  vector<TraceOp> ops;
+};
+
+bool applyOp(CardList& hand, const TraceOp& op) {
+  if (!op.erase) return hand.contains(op.card);
+  hand.remove(op.card);
+  return false;
+}
+bool applyOp(SplayCardList& hand, const TraceOp& op) {
+  if (!op.erase) return hand.contains(op.card);
+  hand.remove(op.card);
+  return false;
+}
+bool applyOp(set<Card>& hand, const TraceOp& op) {
+  if (!op.erase) return hand.count(op.card) != 0;
+  hand.erase(op.card);
+  return false;
+}
+
+// replay every trace `rounds` times; hands are built untimed
+template <typename Hand>
+double replayTraces(const vector<Trace>& traces, size_t rounds, bool balance, size_t& hits) {
+  Clock::duration total{};
+  size_t ops = 0;
+  for (size_t r = 0; r < rounds; ++r) {
+    vector<Hand> hands(2 * traces.size());
+    for (size_t t = 0; t < traces.size(); ++t) {
+      for (int h = 0; h < 2; ++h) {
+        build(hands[2 * t + h], traces[t].hands[h]);
+        if constexpr (is_same_v<Hand, CardList>) {
+          if (balance) hands[2 * t + h].rebalance();
+        }
+      }
+    }
+    Clock::time_point begin = Clock::now();
+    for (size_t t = 0; t < traces.size(); ++t) {
+      for (const TraceOp& op : traces[t].ops) hits += applyOp(hands[2 * t + op.hand], op);
+    }
+    total += Clock::now() - begin;
+    for (const Trace& t : traces) ops += t.ops.size();
+  }
+  return chrono::duration<double, nano>(total).count() / ops;
+}
+
+// ns per replayed operation; every container must see the same hits
+void benchTraces(const char* label, const vector<Trace>& traces, size_t rounds) {
+  size_t ops = 0;
+  for (const Trace& t : traces) ops += t.ops.size();
+  cout << label << " (" << traces.size() << " games, " << ops << " operations)" << endl;
+  size_t reference = 0;
+  for (Kind kind : KINDS) {
+    size_t hits = 0;
+    double ns = 0;
+    if (kind == Kind::BST || kind == Kind::BALANCED) ns = replayTraces<CardList>(traces, rounds, kind == Kind::BALANCED, hits);
+    else if (kind == Kind::SPLAY) ns = replayTraces<SplayCardList>(traces, rounds, false, hits);
+    else ns = replayTraces<set<Card>>(traces, rounds, false, hits);
+    if (kind == KINDS[0]) reference = hits;
+    cout << "  " << left << setw(14) << KIND_NAMES[static_cast<int>(kind)] << right
+         << fixed << setprecision(1) << setw(10) << ns << " ns/op"
+         << (hits == reference ? "" : "  MISMATCH") << endl;
+  }
+}
+
+// ns per contains() over the full deck inserted in sorted order
+// (the worst case for the plain BST)
+template <typename Hand>
+double timeLookups(Hand& hand, const vector<Card>& queries, size_t& hits) {
+  Clock::time_point begin = Clock::now();
+  for (const Card& c : queries) hits += hand.contains(c);
+  return chrono::duration<double, nano>(Clock::now() - begin).count() / queries.size();
+}
+
+double timeLookups(set<Card>& hand, const vector<Card>& queries, size_t& hits) {
+  Clock::time_point begin = Clock::now();
+  for (const Card& c : queries) hits += hand.count(c);
+  return chrono::duration<double, nano>(Clock::now() - begin).count() / queries.size();
+}
+
+void benchLookups(const char* label, const vector<Card>& queries) {
+  cout << label << endl;
+  vector<Card> deck;
+  for (int i = 0; i < 52; ++i) deck.push_back(cardFromIndex(i));
+  for (Kind kind : KINDS) {
+    size_t hits = 0;
+    double ns = 0;
+    if (kind == Kind::BST || kind == Kind::BALANCED) {
+      CardList hand;
+      build(hand, deck);
+      if (kind == Kind::BALANCED) hand.rebalance();
+      ns = timeLookups(hand, queries, hits);
+    } else if (kind == Kind::SPLAY) {
+      SplayCardList hand;
+      build(hand, deck);
+      ns = timeLookups(hand, queries, hits);
+    } else {
+      set<Card> hand;
+      build(hand, deck);
+      ns = timeLookups(hand, queries, hits);
+    }
+    cout << "  " << left << setw(14) << KIND_NAMES[static_cast<int>(kind)] << right
+         << fixed << setprecision(1) << setw(10) << ns << " ns/lookup"
+         << (hits == queries.size() ? "" : "  MISMATCH") << endl;
+  }
+}
+
+// Zipf(s) popularity over a random ranking of the 52 cards
+vector<Card> zipfQueries(mt19937_64& rng, double s) {
+  vector<int> ranking(52);
+  for (int i = 0; i < 52; ++i) ranking[i] = i;
+  shuffle(ranking.begin(), ranking.end(), rng);
+  vector<double> weights;
+  for (int i = 0; i < 52; ++i) weights.push_back(1.0 / pow(i + 1, s));
+  discrete_distribution<int> pick(weights.begin(), weights.end());
+  vector<Card> queries;
+  for (size_t i = 0; i < LOOKUPS; ++i) queries.push_back(cardFromIndex(ranking[pick(rng)]));
+  return queries;
+}
+
+// a few cards take hotShare of the lookups; the hot set moves every phase
+vector<Card> hotSetQueries(mt19937_64& rng, int hotCards, double hotShare, size_t phase) {
+  uniform_int_distribution<int> any(0, 51);
+  uniform_real_distribution<double> coin(0, 1);
+  vector<int> hot(hotCards);
+  vector<Card> queries;
+  for (size_t i = 0; i < LOOKUPS; ++i) {
+    if (i % phase == 0) {
+      for (int& h : hot) h = any(rng);
+    }
+    int idx = coin(rng) < hotShare ? hot[rng() % hotCards] : any(rng);
+    queries.push_back(cardFromIndex(idx));
+  }
+  return queries;
+}
+
+// both ends of the deck, narrowing like the two game cursors
+vector<Card> endsQueries() {
+  vector<Card> queries;
+  int lo = 0, hi = 51;
+  for (size_t i = 0; i < LOOKUPS; ++i) {
+    queries.push_back(cardFromIndex(i % 2 == 0 ? lo : hi));
+    if (i % 8 == 7 && ++lo >= --hi) {
+      lo = 0;
+      hi = 51;
+    }
+  }
+  return queries;
+}
+
+// ns per deal from masks to outcome: CardList games (fromMask, playGame)
+// against each deal kernel the CPU supports
+void benchKernels(mt19937_64& rng) {
+  cout << "mask deals, " << KERNEL_DEALS << " random pairs" << endl;
+  vector<uint64_t> alice(KERNEL_DEALS), bob(KERNEL_DEALS);
+  for (size_t i = 0; i < KERNEL_DEALS; ++i) {
+    alice[i] = rng() & DECK_MASK;
+    bob[i] = rng() & DECK_MASK;
+  }
+
+  vector<Outcome> reference(KERNEL_DEALS);
+  deal::playDeals(deal::Kernel::SCALAR, alice.data(), bob.data(), KERNEL_DEALS, reference.data());
+
+  Clock::time_point begin = Clock::now();
+  vector<Card> moves;
+  bool same = true;
+  for (size_t i = 0; i < KERNEL_TREE_DEALS; ++i) {
+    CardList a, b;
+    fromMask(a, alice[i]);
+    fromMask(b, bob[i]);
+    moves.clear();
+    playGame(a, b, moves);
+    same = same && moves.size() == reference[i].moveCount;
+  }
+  double ns = chrono::duration<double, nano>(Clock::now() - begin).count() / KERNEL_TREE_DEALS;
+  cout << "  " << left << setw(14) << "CardList" << right << fixed << setprecision(1)
+       << setw(10) << ns << " ns/deal" << (same ? "" : "  MISMATCH") << endl;
+
+  vector<Outcome> out(KERNEL_DEALS);
+  for (deal::Kernel kernel : {deal::Kernel::SCALAR, deal::Kernel::AVX2, deal::Kernel::AVX512}) {
+    if (!deal::supported(kernel)) continue;
+    begin = Clock::now();
+    deal::playDeals(kernel, alice.data(), bob.data(), KERNEL_DEALS, out.data());
+    ns = chrono::duration<double, nano>(Clock::now() - begin).count() / KERNEL_DEALS;
+    same = true;
+    for (size_t i = 0; i < KERNEL_DEALS; ++i) {
+      same = same && out[i].moveCount == reference[i].moveCount && out[i].alice == reference[i].alice
+             && out[i].bob == reference[i].bob
+             && equal(out[i].moves, out[i].moves + out[i].moveCount, reference[i].moves);
+    }
+    cout << "  " << left << setw(14) << deal::name(kernel) << right << fixed << setprecision(1)
+         << setw(10) << ns << " ns/deal" << (same ? "" : "  MISMATCH") << endl;
+  }
+}
+
+// Same shape as CardList's node, with a 64-bit key: a hand of Card keys
+// tops out at about 70 nodes, far too small to miss in cache
+struct BigNode {
+  uint64_t key;
+  BigNode* left;
+  BigNode* right;
+  BigNode* parent;
+  bool dead;
+};
+
+// balanced over sorted keys, but the nodes sit at random places in the
+// pool, like a tree whose nodes were allocated one by one
+BigNode* buildBig(vector<BigNode>& pool, const vector<size_t>& slot, size_t lo, size_t hi, BigNode* parent) {
+  if (lo >= hi) return nullptr;
+  size_t mid = lo + (hi - lo) / 2;
+  BigNode* n = &pool[slot[mid]];
+  n->key = 2 * mid; // odd probes miss
+  n->dead = false;
+  n->parent = parent;
+  n->left = buildBig(pool, slot, lo, mid, n);
+  n->right = buildBig(pool, slot, mid + 1, hi, n);
+  return n;
+}
+
+// the one-at-a-time baseline: CardList::search_helper, line for line,
+// over the big tree
+bool searchBig(const BigNode* node, uint64_t key) {
+  if (node == nullptr) return false;
+  if (key == node->key) return !node->dead;
+  if (key < node->key) return searchBig(node->left, key);
+  return searchBig(node->right, key);
+}
+
+template <size_t GROUP>
+double timeInterleaved(const BigNode* root, const vector<uint64_t>& keys, bool* found) {
+  Clock::time_point begin = Clock::now();
+  probeInterleaved<GROUP>(root, keys.data(), keys.size(), found,
+                          [](const BigNode* node, uint64_t key, bool& hit) -> const BigNode* {
+    if (key == node->key) {
+      hit = !node->dead;
+      return nullptr;
+    }
+    const BigNode* child = key < node->key ? node->left : node->right;
+    if (child == nullptr) hit = false;
+    return child;
+  });
+  return chrono::duration<double, nano>(Clock::now() - begin).count() / keys.size();
+}
+
+void reportProbes(const string& label, double ns, double baseline, bool same) {
+  cout << "  " << left << setw(22) << label << right << fixed << setprecision(1) << setw(8) << ns
+       << " ns/lookup  x" << setprecision(2) << baseline / ns << (same ? "" : "  MISMATCH") << endl;
+}
+
+void benchProbes(mt19937_64& rng) {
+  cout << "batched lookups, " << BIG_TREE_NODES << "-node tree, random keys" << endl;
+  vector<size_t> slot(BIG_TREE_NODES);
+  for (size_t i = 0; i < BIG_TREE_NODES; ++i) slot[i] = i;
+  shuffle(slot.begin(), slot.end(), rng);
+  vector<BigNode> pool(BIG_TREE_NODES);
+  const BigNode* root = buildBig(pool, slot, 0, BIG_TREE_NODES, nullptr);
+  slot = vector<size_t>();
+
+  vector<uint64_t> keys(BIG_TREE_PROBES);
+  uniform_int_distribution<uint64_t> any(0, 2 * BIG_TREE_NODES - 1);
+  for (uint64_t& k : keys) k = any(rng);
+
+  unique_ptr<bool[]> expected(new bool[keys.size()]);
+  unique_ptr<bool[]> found(new bool[keys.size()]);
+  auto same = [&](size_t n) { return equal(found.get(), found.get() + n, expected.get()); };
+  for (size_t i = 0; i < keys.size() / 8; ++i) expected[i] = searchBig(root, keys[i]); // warm up
+  Clock::time_point begin = Clock::now();
+  for (size_t i = 0; i < keys.size(); ++i) expected[i] = searchBig(root, keys[i]);
+  double baseline = chrono::duration<double, nano>(Clock::now() - begin).count() / keys.size();
+  reportProbes("one at a time", baseline, baseline, true);
+
+  double ns = timeInterleaved<4>(root, keys, found.get());
+  reportProbes("interleaved, 4", ns, baseline, same(keys.size()));
+  ns = timeInterleaved<8>(root, keys, found.get());
+  reportProbes("interleaved, 8", ns, baseline, same(keys.size()));
+  ns = timeInterleaved<16>(root, keys, found.get());
+  reportProbes("interleaved, 16", ns, baseline, same(keys.size()));
+  ns = timeInterleaved<32>(root, keys, found.get());
+  reportProbes("interleaved, 32", ns, baseline, same(keys.size()));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint64_t seed = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1;
+  mt19937_64 rng(seed);
+
+  benchGames("games, shuffled deals", false, seed);
+  benchGames("games, sorted deals", true, seed);
+
+  // traces recorded from the sample hand files, when run from the repo
+  vector<Trace> samples;
+  for (int i = 0; i < 4; ++i) {
+    Trace t;
+    t.hands[0] = loadHand("a" + to_string(i) + ".txt");
+    t.hands[1] = loadHand("b" + to_string(i) + ".txt");
+    t.ops = recordTrace(t.hands[0], t.hands[1]);
+    if (!t.ops.empty()) samples.push_back(t);
+  }
+  if (!samples.empty()) benchTraces("replayed traces, sample hand files", samples, 20000);
+
+  vector<Trace> recorded;
+  mt19937_64 dealRng(seed);
+  for (size_t i = 0; i < GAME_BATCH; ++i) {
+    Deal d = randomDeal(dealRng, false);
+    Trace t;
+    t.hands[0] = d.alice;
+    t.hands[1] = d.bob;
+    t.ops = recordTrace(d.alice, d.bob);
+    recorded.push_back(t);
+  }
+  benchTraces("replayed traces, random shuffled deals", recorded, 50);
+
+  vector<Card> uniform;
+  uniform_int_distribution<int> any(0, 51);
+  for (size_t i = 0; i < LOOKUPS; ++i) uniform.push_back(cardFromIndex(any(rng)));
+  benchLookups("lookups, uniform", uniform);
+  benchLookups("lookups, zipf s=1.2", zipfQueries(rng, 1.2));
+  benchLookups("lookups, 4 hot cards take 90%, moving every 10000", hotSetQueries(rng, 4, 0.9, 10000));
+  benchLookups("lookups, alternating low/high ends", endsQueries());
+
+  benchKernels(rng);
+  benchProbes(rng);
+  return 0;
+}
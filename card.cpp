@@ -6,6 +6,12 @@
 #include <ostream>
 #include <array>
 #include <algorithm>
+#include <cassert>
+
+namespace {
+constexpr std::array<char,4> suit_order = {'c', 'd', 's', 'h'}; // ascending order
+constexpr std::array<char,13> rank_order = {'a', '2', '3', '4', '5', '6', '7', '8', '9', 't', 'j', 'q', 'k'}; // ascending order
+}
 
 // Constructors
 Card::Card() : suit(' '), rank(' ') {}
@@ -29,12 +35,10 @@ bool operator==(const Card &a, const Card &b) {
 }
 
 bool operator<(const Card &a, const Card &b) {
-    constexpr std::array<char,4> suit_order = {'c', 'd', 's', 'h'}; // ascending order
     auto suit_a = std::find(suit_order.begin(), suit_order.end(), a.getSuit()) - suit_order.begin();
     auto suit_b = std::find(suit_order.begin(), suit_order.end(), b.getSuit()) - suit_order.begin();
     if (suit_a != suit_b) return suit_a < suit_b; // compare suits first
 
-    constexpr std::array<char,13> rank_order = {'a', '2', '3', '4', '5', '6', '7', '8', '9', 't', 'j', 'q', 'k'}; // ascending order
     auto rank_a = std::find(rank_order.begin(), rank_order.end(), a.getRank()) - rank_order.begin();
     auto rank_b = std::find(rank_order.begin(), rank_order.end(), b.getRank()) - rank_order.begin();
     return rank_a < rank_b; // compare ranks if suits are the same
@@ -46,4 +50,17 @@ bool operator>(const Card &a, const Card &b) { return b < a; }
 std::ostream &operator<<(std::ostream &os, const Card &c) {
 	c.print(os);
 	return os;
-}
\ No newline at end of file
+}
+
+// Dense card index: suit position * 13 + rank position
+int cardIndex(const Card &c) {
+    auto suit = std::find(suit_order.begin(), suit_order.end(), c.getSuit()) - suit_order.begin();
+    auto rank = std::find(rank_order.begin(), rank_order.end(), c.getRank()) - rank_order.begin();
+    if (suit == 4 || rank == 13) return -1;
+    return static_cast<int>(suit * 13 + rank);
+}
+
+Card cardFromIndex(int index) {
+    assert(index >= 0 && index < 52);
+    return Card(suit_order[index / 13], rank_order[index % 13]);
+}
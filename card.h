@@ -5,6 +5,7 @@
 #ifndef CARD_H
 #define CARD_H
 
+#include <cstdint>
 #include <iosfwd>
 
 class Card {
@@ -32,4 +33,12 @@ bool operator<(const Card &a, const Card &b);
 bool operator>(const Card &a, const Card &b);
 std::ostream &operator<<(std::ostream &os, const Card &c);
 
+// Dense index of a standard card in operator< order (c a = 0 ... h k = 51).
+// Returns -1 for cards outside the 52-card deck.
+int cardIndex(const Card &c);
+// Inverse of cardIndex (index must be in [0, 52))
+Card cardFromIndex(int index);
+// Every deck card in a hand mask (bit cardIndex(c) set per card held)
+constexpr std::uint64_t DECK_MASK = (std::uint64_t(1) << 52) - 1;
+
 #endif
@@ -3,25 +3,65 @@
 // Implementation of the classes defined in card_list.h
 
 #include "card_list.h"
+#include "play_game.h"
 #include <iostream>
 
 // Node Constructor
-CardList::Node::Node(const Card& c) : card(c), left(nullptr), right(nullptr) {
+CardList::Node::Node(const Card& c) : card(c), left(nullptr), right(nullptr), parent(nullptr), dead(false) {
 }
 
 // CardList Constructor
-CardList::CardList() : root(nullptr) {
+CardList::CardList()
+    : root(nullptr), first(nullptr), last(nullptr), count(0), deadCount(0), lazyDelete(false),
+      compactThreshold(0.25), walkedHints(0) {
 }
 
 // CardList Copy constructor
-CardList::CardList(const CardList& other) : root(copy_helper(other.root)) {
+CardList::CardList(const CardList& other)
+    : root(copy_helper(other.root, nullptr)), first(nullptr), last(nullptr), count(other.count),
+      deadCount(other.deadCount), lazyDelete(other.lazyDelete), compactThreshold(other.compactThreshold),
+      walkedHints(0) {
+    refresh_ends();
 }
 
 // CardList Copy-assignment
 CardList& CardList::operator=(const CardList& other) {
     if (this != &other) {
         delete_helper(root);
-        root = copy_helper(other.root);
+        root = copy_helper(other.root, nullptr);
+        refresh_ends();
+        count = other.count;
+        deadCount = other.deadCount;
+        lazyDelete = other.lazyDelete;
+        compactThreshold = other.compactThreshold;
+    }
+    return *this;
+}
+
+// CardList Move constructor (steals the tree)
+CardList::CardList(CardList&& other) noexcept
+    : root(other.root), first(other.first), last(other.last), count(other.count),
+      deadCount(other.deadCount), lazyDelete(other.lazyDelete), compactThreshold(other.compactThreshold),
+      walkedHints(0) {
+    other.root = other.first = other.last = nullptr;
+    other.count = 0;
+    other.deadCount = 0;
+}
+
+// CardList Move-assignment
+CardList& CardList::operator=(CardList&& other) noexcept {
+    if (this != &other) {
+        delete_helper(root);
+        root = other.root;
+        first = other.first;
+        last = other.last;
+        count = other.count;
+        deadCount = other.deadCount;
+        lazyDelete = other.lazyDelete;
+        compactThreshold = other.compactThreshold;
+        other.root = other.first = other.last = nullptr;
+        other.count = 0;
+        other.deadCount = 0;
     }
     return *this;
 }
@@ -31,6 +71,14 @@ CardList::~CardList() {
     delete_helper(root);
 }
 
+// Remove every card, leaving an empty hand
+void CardList::clear() {
+    delete_helper(root);
+    root = first = last = nullptr;
+    count = 0;
+    deadCount = 0;
+}
+
 // Helper function to delete all nodes
 void CardList::delete_helper(Node* node) {
     if (node == nullptr) return;
@@ -41,68 +89,122 @@ void CardList::delete_helper(Node* node) {
 }
 
 // Helper to deep-copy a subtree
-CardList::Node* CardList::copy_helper(Node* node) const {
+CardList::Node* CardList::copy_helper(Node* node, Node* parent) {
     if (node == nullptr) return nullptr;
     Node* n = new Node(node->card);
-    n->left = copy_helper(node->left);
-    n->right = copy_helper(node->right);
+    n->dead = node->dead;
+    n->parent = parent;
+    n->left = copy_helper(node->left, n);
+    n->right = copy_helper(node->right, n);
     return n;
 }
 
 // Insert a card into the BST
 void CardList::insert(const Card& card) {
-    root = insert_helper(root, card);
+    insert_node(card);
 }
 
-// Helper function for insert
-CardList::Node* CardList::insert_helper(Node* node, const Card& card) {
-    if (node == nullptr) {
-        return new Node(card);
-    }
-
-    if (card < node->card) {
-        node->left = insert_helper(node->left, card);
-    } else if (card > node->card) {
-        node->right = insert_helper(node->right, card);
-    } // if equal, do nothing (no duplicates)
+// Helper: link a new leaf under parent (or as the root when parent is null)
+CardList::Node* CardList::attach(Node* parent, bool asLeft, const Card& card) {
+    Node* n = new Node(card);
+    n->parent = parent;
+    if (parent == nullptr) root = first = last = n;
+    else if (asLeft) parent->left = n;
+    else parent->right = n;
+    // only a left child of the smallest node (right of the largest) is a new end
+    if (parent == first && asLeft) first = n;
+    if (parent == last && !asLeft) last = n;
+    ++count;
+    return n;
+}
 
-    return node;
+// Helper function for insert: returns the node now holding card
+CardList::Node* CardList::insert_node(const Card& card) {
+    Node* parent = nullptr;
+    Node* cur = root;
+    while (cur) {
+        parent = cur;
+        if (card < cur->card) {
+            cur = cur->left;
+        } else if (card > cur->card) {
+            cur = cur->right;
+        } else {
+            if (cur->dead) {
+                // re-inserting a lazily removed card revives its node
+                cur->dead = false;
+                --deadCount;
+                ++count;
+            } // if equal, do nothing (no duplicates)
+            return cur;
+        }
+    }
+    return attach(parent, parent && card < parent->card, card);
 }
 
 // Remove a card from the BST
 void CardList::remove(const Card& card) {
-    root = remove_helper(root, card);
+    Node* n = find_node(card);
+    if (n != nullptr && !n->dead) erase_node(n);
 }
 
-// Helper function for remove
-CardList::Node* CardList::remove_helper(Node* node, const Card& card) {
-    if (node == nullptr) return nullptr;
+// Helper: find the node holding card, dead or alive
+CardList::Node* CardList::find_node(const Card& card) const {
+    Node* cur = root;
+    while (cur && !(card == cur->card)) {
+        cur = (card < cur->card) ? cur->left : cur->right;
+    }
+    return cur;
+}
 
-    if (card < node->card) {
-        node->left = remove_helper(node->left, card);
-        return node;
-    } else if (card > node->card) {
-        node->right = remove_helper(node->right, card);
-        return node;
+// Helper: remove a live node; lazy mode marks it dead and compacts once
+// tombstones pile up, eager mode unlinks it
+void CardList::erase_node(Node* node) {
+    if (!lazyDelete) {
+        unlink_node(node);
+        return;
     }
+    node->dead = true;
+    --count;
+    ++deadCount;
+    if (deadCount > compactThreshold * (count + deadCount)) rebalance();
+}
 
-    // node->card == card: remove this node
+// Helper: unlink a node from the tree and free it
+void CardList::unlink_node(Node* node) {
+    if (node == first) first = nextNode(node);
+    if (node == last) last = prevNode(node);
+    Node* replacement;
     if (node->left == nullptr) {
-        Node* rightChild = node->right;
-        delete node;
-        return rightChild;
+        replacement = node->right;
     } else if (node->right == nullptr) {
-        Node* leftChild = node->left;
-        delete node;
-        return leftChild;
+        replacement = node->left;
     } else {
-        // two children: replace with inorder successor (smallest in right subtree)
-        Node* succ = node->right;
-        while (succ->left != nullptr) succ = succ->left;
-        node->card = succ->card; // copy value
-        node->right = remove_helper(node->right, succ->card); // remove successor
-        return node;
+        // two children: splice the inorder successor (smallest in right
+        // subtree) into this node's place
+        Node* succ = minimumNode(node->right);
+        if (succ != node->right) {
+            succ->parent->left = succ->right;
+            if (succ->right) succ->right->parent = succ->parent;
+            succ->right = node->right;
+            node->right->parent = succ;
+        }
+        succ->left = node->left;
+        node->left->parent = succ;
+        replacement = succ;
     }
+
+    if (replacement) replacement->parent = node->parent;
+    if (node->parent == nullptr) root = replacement;
+    else if (node->parent->left == node) node->parent->left = replacement;
+    else node->parent->right = replacement;
+    drop_node(node);
+}
+
+// Free a node unlinked from the tree, keeping the counters in step
+void CardList::drop_node(Node* node) {
+    if (node->dead) --deadCount;
+    else --count;
+    delete node;
 }
 
 // Search for a card in the BST (internal)
@@ -118,11 +220,16 @@ bool CardList::contains(const Card& card) const {
 // Helper function for search
 bool CardList::search_helper(Node* node, const Card& card) const {
     if (node == nullptr) return false;
-    if (card == node->card) return true;
+    if (card == node->card) return !node->dead;
     if (card < node->card) return search_helper(node->left, card);
     return search_helper(node->right, card);
 }
 
+// Number of cards held
+std::size_t CardList::size() const {
+    return count;
+}
+
 // Print all cards in the BST (in-order traversal)
 void CardList::print(std::ostream& os) const {
     print_helper(root, os);
@@ -132,10 +239,156 @@ void CardList::print(std::ostream& os) const {
 void CardList::print_helper(Node* node, std::ostream& os) const {
     if (node == nullptr) return;
     print_helper(node->left, os);
-    os << ' ' << node->card;
+    if (!node->dead) os << ' ' << node->card;
     print_helper(node->right, os);
 }
 
+// set algebra
+
+// Helper: collect the live nodes of a subtree in order (tombstones go to
+// dead when given, and are skipped otherwise)
+void CardList::flatten_helper(Node* node, std::vector<Node*>& live, std::vector<Node*>* dead) {
+    if (node == nullptr) return;
+    flatten_helper(node->left, live, dead);
+    if (!node->dead) live.push_back(node);
+    else if (dead) dead->push_back(node);
+    flatten_helper(node->right, live, dead);
+}
+
+// Helper: relink n in-order nodes into a balanced tree (middle node as root)
+CardList::Node* CardList::build_balanced(Node* const* nodes, std::size_t n, Node* parent) {
+    if (n == 0) return nullptr;
+    std::size_t mid = n / 2;
+    Node* node = nodes[mid];
+    node->parent = parent;
+    node->left = build_balanced(nodes, mid, node);
+    node->right = build_balanced(nodes + mid + 1, n - mid - 1, node);
+    return node;
+}
+
+// Merge into a new list: fresh nodes for every card kept
+CardList CardList::merged(const CardList& other, unsigned keep) const {
+    std::vector<Node*> mine, theirs, out;
+    mine.reserve(count);
+    theirs.reserve(other.count);
+    flatten_helper(root, mine, nullptr);
+    flatten_helper(other.root, theirs, nullptr);
+    out.reserve(mine.size() + theirs.size());
+
+    std::size_t i = 0, j = 0;
+    while (i < mine.size() || j < theirs.size()) {
+        if (j == theirs.size() || (i < mine.size() && mine[i]->card < theirs[j]->card)) {
+            if (keep & ONLY_THIS) out.push_back(new Node(mine[i]->card));
+            ++i;
+        } else if (i == mine.size() || mine[i]->card > theirs[j]->card) {
+            if (keep & ONLY_OTHER) out.push_back(new Node(theirs[j]->card));
+            ++j;
+        } else {
+            if (keep & IN_BOTH) out.push_back(new Node(mine[i]->card));
+            ++i;
+            ++j;
+        }
+    }
+
+    CardList result;
+    result.root = build_balanced(out.data(), out.size(), nullptr);
+    result.refresh_ends();
+    result.count = out.size();
+    return result;
+}
+
+// Merge into this list: kept nodes are relinked, dropped nodes freed,
+// and only cards coming from other are allocated
+void CardList::merge_in_place(const CardList& other, unsigned keep) {
+    if (this == &other) {
+        CardList copy(other);
+        merge_in_place(copy, keep);
+        return;
+    }
+
+    std::vector<Node*> mine, theirs, out, dead;
+    mine.reserve(count);
+    theirs.reserve(other.count);
+    flatten_helper(root, mine, &dead);
+    flatten_helper(other.root, theirs, nullptr);
+    for (Node* n : dead) delete n;
+    out.reserve(mine.size() + theirs.size());
+
+    std::size_t i = 0, j = 0;
+    while (i < mine.size() || j < theirs.size()) {
+        if (j == theirs.size() || (i < mine.size() && mine[i]->card < theirs[j]->card)) {
+            if (keep & ONLY_THIS) out.push_back(mine[i]);
+            else delete mine[i];
+            ++i;
+        } else if (i == mine.size() || mine[i]->card > theirs[j]->card) {
+            if (keep & ONLY_OTHER) out.push_back(new Node(theirs[j]->card));
+            ++j;
+        } else {
+            if (keep & IN_BOTH) out.push_back(mine[i]);
+            else delete mine[i];
+            ++i;
+            ++j;
+        }
+    }
+
+    root = build_balanced(out.data(), out.size(), nullptr);
+    refresh_ends();
+    count = out.size();
+    deadCount = 0;
+}
+
+void CardList::rebalance() {
+    std::vector<Node*> nodes, dead;
+    nodes.reserve(count);
+    dead.reserve(deadCount);
+    flatten_helper(root, nodes, &dead);
+    for (Node* n : dead) delete n;
+    deadCount = 0;
+    root = build_balanced(nodes.data(), nodes.size(), nullptr);
+    refresh_ends();
+}
+
+void CardList::refresh_ends() {
+    first = minimumNode(root);
+    last = maximumNode(root);
+}
+
+void CardList::setLazyDelete(bool enabled, double threshold) {
+    lazyDelete = enabled;
+    compactThreshold = threshold;
+    if (!enabled && deadCount > 0) rebalance();
+}
+
+std::size_t CardList::tombstones() const {
+    return deadCount;
+}
+
+CardList CardList::set_union(const CardList& other) const {
+    return merged(other, ONLY_THIS | IN_BOTH | ONLY_OTHER);
+}
+CardList CardList::set_intersection(const CardList& other) const {
+    return merged(other, IN_BOTH);
+}
+CardList CardList::set_difference(const CardList& other) const {
+    return merged(other, ONLY_THIS);
+}
+CardList CardList::set_symmetric_difference(const CardList& other) const {
+    return merged(other, ONLY_THIS | ONLY_OTHER);
+}
+
+void CardList::set_union_with(const CardList& other) {
+    merge_in_place(other, ONLY_THIS | IN_BOTH | ONLY_OTHER);
+}
+void CardList::set_intersection_with(const CardList& other) {
+    merge_in_place(other, IN_BOTH);
+}
+void CardList::set_difference_with(const CardList& other) {
+    merge_in_place(other, ONLY_THIS);
+}
+void CardList::set_symmetric_difference_with(const CardList& other) {
+    merge_in_place(other, ONLY_THIS | ONLY_OTHER);
+}
+
 // iterator implementation
 
 // iterator helpers
@@ -159,46 +412,34 @@ CardList::Node* CardList::maximumNode(Node* n) {
     return n;
 }
 
-// successor: next larger node in the tree (or nullptr if none)
-CardList::Node* CardList::iterator::successor(Node* n) const {
+// next larger node in the tree (or nullptr if none)
+CardList::Node* CardList::nextNode(Node* n) {
     if (n == nullptr) return nullptr;
     if (n->right) return minimumNode(n->right);
-
-    // walk from root to find lowest ancestor greater than n
-    Node* succ = nullptr;
-    Node* cur = tree->root;
-    while (cur) {
-        if (n->card < cur->card) {
-            succ = cur;
-            cur = cur->left;
-        } else if (n->card > cur->card) {
-            cur = cur->right;
-        } else break;
-    }
-    return succ;
+    // climb until we arrive from a left child
+    while (n->parent && n->parent->right == n) n = n->parent;
+    return n->parent;
 }
 
-// predecessor: next smaller node in the tree (or nullptr if none)
-CardList::Node* CardList::iterator::predecessor(Node* n) const {
+// next smaller node in the tree (or nullptr if none)
+CardList::Node* CardList::prevNode(Node* n) {
     if (n == nullptr) return nullptr;
     if (n->left) return maximumNode(n->left);
+    while (n->parent && n->parent->left == n) n = n->parent;
+    return n->parent;
+}
 
-    Node* pred = nullptr;
-    Node* cur = tree->root;
-    while (cur) {
-        if (n->card > cur->card) {
-            pred = cur;
-            cur = cur->right;
-        } else if (n->card < cur->card) {
-            cur = cur->left;
-        } else break;
-    }
-    return pred;
+void CardList::iterator::skip_dead_forward() {
+    while (node && node->dead) node = nextNode(node);
+}
+void CardList::iterator::skip_dead_backward() {
+    while (node && node->dead) node = prevNode(node);
 }
 
 // pre-increment: move to successor
 CardList::iterator& CardList::iterator::operator++() {
-    node = successor(node);
+    node = nextNode(node);
+    skip_dead_forward();
     return *this;
 }
 CardList::iterator CardList::iterator::operator++(int) {
@@ -210,10 +451,11 @@ CardList::iterator CardList::iterator::operator++(int) {
 // pre-decrement: move to predecessor; if node==nullptr (end()) move to maximum
 CardList::iterator& CardList::iterator::operator--() {
     if (node == nullptr) {
-        node = maximumNode(tree->root);
+        node = tree->last;
     } else {
-        node = predecessor(node);
+        node = prevNode(node);
     }
+    skip_dead_backward();
     return *this;
 }
 CardList::iterator CardList::iterator::operator--(int) {
@@ -230,41 +472,106 @@ bool CardList::iterator::operator!=(const iterator& other) const {
 }
 
 // CardList iterator entry points
-CardList::iterator CardList::begin() const { return iterator(minimumNode(root), this); }
+CardList::iterator CardList::begin() const {
+    iterator it(first, this);
+    it.skip_dead_forward();
+    return it;
+}
 CardList::iterator CardList::end() const { return iterator(nullptr, this); }
-CardList::iterator CardList::rbegin() const { return iterator(maximumNode(root), this); }
+CardList::iterator CardList::rbegin() const {
+    iterator it(last, this);
+    it.skip_dead_backward();
+    return it;
+}
 CardList::iterator CardList::rend() const { return iterator(nullptr, this); }
 
-// playGame: manage game logic using only public CardList methods + iterators
-void playGame(CardList &alice, CardList &bob) {
-    while (true) {
-        bool aliceFound = false;
-        // Alice: smallest -> largest
-        for (CardList::iterator it = alice.begin(); it != alice.end(); ++it) {
-            Card c = *it;
-            if (bob.contains(c)) {
-                std::cout << "Alice picked matching card " << c << std::endl;
-                bob.remove(c);
-                alice.remove(c);
-                aliceFound = true;
-                break;
-            }
+// iterator-based access
+CardList::iterator CardList::find(const Card& card) const {
+    Node* n = find_node(card);
+    return iterator(n && !n->dead ? n : nullptr, this);
+}
+
+CardList::iterator CardList::insert(iterator hint, const Card& card) {
+    Node* h = hint.node;
+    if (h == nullptr) {
+        // end(): append after the largest node
+        if (last == nullptr || card > last->card) return iterator(attach(last, false, card), this);
+    } else if (card > h->card) {
+        // goes right after h: h's right slot, or the left slot of h's successor
+        if (h == last) return iterator(attach(h, false, card), this);
+        ++walkedHints;
+        Node* next = nextNode(h);
+        if (card < next->card) {
+            return iterator(h->right == nullptr ? attach(h, false, card) : attach(next, true, card), this);
         }
-        if (!aliceFound) break;
-
-        bool bobFound = false;
-        // Bob: largest -> smallest (use rbegin()/rend() and operator--)
-        for (CardList::iterator rit = bob.rbegin(); rit != bob.rend(); --rit) {
-            Card c = *rit;
-            if (alice.contains(c)) {
-                std::cout << "Bob picked matching card " << c << std::endl;
-                alice.remove(c);
-                bob.remove(c);
-                bobFound = true;
-                break;
-            }
+    } else if (card < h->card) {
+        if (h == first) return iterator(attach(h, true, card), this);
+        ++walkedHints;
+        Node* prev = prevNode(h);
+        if (card > prev->card) {
+            return iterator(h->left == nullptr ? attach(h, true, card) : attach(prev, false, card), this);
         }
-        if (!bobFound) break;
+    } else if (!h->dead) {
+        return hint; // already held
+    }
+    // wrong hint (or the card is already present): ordinary insert
+    if (h == nullptr || card == h->card) ++walkedHints;
+    return iterator(insert_node(card), this);
+}
+
+std::size_t CardList::hintWalks() const { return walkedHints; }
+
+CardList::iterator CardList::erase(iterator pos) {
+    iterator next = pos;
+    ++next;
+    // lazy compaction relinks nodes but keeps the live ones, so next stays valid
+    erase_node(pos.node);
+    return next;
+}
+
+// playGame: manage game logic using only public CardList methods + iterators
+void playGame(CardList &alice, CardList &bob, std::vector<Card> &moves) {
+    playHands(alice, bob, moves);
+}
+
+// playGame: print each pick as it was made
+void playGame(CardList &alice, CardList &bob) {
+    std::vector<Card> moves;
+    playGame(alice, bob, moves);
+    printMoves(moves, std::cout);
+}
+
+void printMoves(const std::vector<Card> &moves, std::ostream &os) {
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        os << (i % 2 == 0 ? "Alice" : "Bob") << " picked matching card " << moves[i] << std::endl;
     }
 }
 
+// Hand <-> 52-bit mask conversion
+bool toMask(const CardList &hand, std::uint64_t &mask) {
+    mask = 0;
+    for (CardList::iterator it = hand.begin(); it != hand.end(); ++it) {
+        int idx = cardIndex(*it);
+        if (idx < 0) return false;
+        mask |= std::uint64_t(1) << idx;
+    }
+    return true;
+}
+
+// insert the middle card first so the tree built from a sorted mask stays shallow
+static void insert_balanced(CardList &hand, const int* idx, int lo, int hi) {
+    if (lo >= hi) return;
+    int mid = lo + (hi - lo) / 2;
+    hand.insert(cardFromIndex(idx[mid]));
+    insert_balanced(hand, idx, lo, mid);
+    insert_balanced(hand, idx, mid + 1, hi);
+}
+
+void fromMask(CardList &hand, std::uint64_t mask) {
+    int idx[52];
+    int n = 0;
+    mask &= DECK_MASK;
+    for (; mask != 0; mask &= mask - 1) idx[n++] = __builtin_ctzll(mask);
+    hand.clear();
+    insert_balanced(hand, idx, 0, n);
+}
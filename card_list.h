@@ -6,8 +6,11 @@
 #define CARD_LIST_H
 
 #include "card.h"
+#include <cstddef>
+#include <cstdint>
 #include <iosfwd>
 #include <iterator>
+#include <vector>
 
 class CardList {
 private:
@@ -15,40 +18,93 @@ private:
         Card card;
         Node* left;
         Node* right;
+        Node* parent;
+        bool dead;   // tombstone left by a lazy remove
         
         Node(const Card& c);
     };
     
     Node* root;
+    Node* first;                // smallest and largest node (tombstones
+    Node* last;                 // included): hinted appends skip the walk
+    std::size_t count;          // live cards
+    std::size_t deadCount;      // tombstones still linked into the tree
+    bool lazyDelete;
+    double compactThreshold;    // dead fraction that triggers a rebuild
+    std::size_t walkedHints;    // hinted inserts that had to walk the tree
     
-    // Helper functions for recursive operations
-    Node* insert_helper(Node* node, const Card& card);
-    Node* remove_helper(Node* node, const Card& card);
+    // Helper functions for node-level operations
+    Node* find_node(const Card& card) const;        // node holding card (even if dead)
+    Node* insert_node(const Card& card);            // node holding card after insert
+    Node* attach(Node* parent, bool asLeft, const Card& card);
+    void erase_node(Node* node);                    // tombstone or unlink, per mode
+    void unlink_node(Node* node);
+    void drop_node(Node* node);
     bool search_helper(Node* node, const Card& card) const;
     void print_helper(Node* node, std::ostream& os) const;
     void delete_helper(Node* node);
-    Node* copy_helper(Node* node) const;
+    static Node* copy_helper(Node* node, Node* parent);
+    void refresh_ends();                            // first/last after a rebuild
 
     // iterator helpers (minimum/maximum used by iterator implementations)
     static Node* minimumNode(Node* n);
     static Node* maximumNode(Node* n);
+    // in-order neighbours through parent links (tombstones included)
+    static Node* nextNode(Node* n);
+    static Node* prevNode(Node* n);
+
+    // bulk helpers: in-order node list <-> balanced tree
+    static void flatten_helper(Node* node, std::vector<Node*>& live, std::vector<Node*>* dead);
+    static Node* build_balanced(Node* const* nodes, std::size_t n, Node* parent);
+
+    // what a set merge keeps: cards only in this list, in both, only in other
+    enum SetPart : unsigned { ONLY_THIS = 1, IN_BOTH = 2, ONLY_OTHER = 4 };
+    CardList merged(const CardList& other, unsigned keep) const;
+    void merge_in_place(const CardList& other, unsigned keep);
     
 public:
     // Constructor, Destructor, and copy
     CardList();
     CardList(const CardList& other);
     CardList& operator=(const CardList& other);
+    CardList(CardList&& other) noexcept;
+    CardList& operator=(CardList&& other) noexcept;
     ~CardList();
     
     // Insertion and removal
     void insert(const Card& card);
     void remove(const Card& card);
+    void clear();
     
     // Search (public API required by assignment)
     bool contains(const Card& card) const;
 
     // backward-compatible alias
     bool search(const Card& card) const;
+
+    std::size_t size() const;
+
+    // Set algebra: linear merges of the two in-order sequences, O(n + m).
+    // Results are built balanced; the *_with variants update this list,
+    // reusing its nodes for the cards it keeps.
+    CardList set_union(const CardList& other) const;
+    CardList set_intersection(const CardList& other) const;
+    CardList set_difference(const CardList& other) const;
+    CardList set_symmetric_difference(const CardList& other) const;
+    void set_union_with(const CardList& other);
+    void set_intersection_with(const CardList& other);
+    void set_difference_with(const CardList& other);
+    void set_symmetric_difference_with(const CardList& other);
+
+    // Relink the nodes into a balanced tree, O(n); also frees tombstones
+    void rebalance();
+
+    // Lazy deletion: remove() only marks the card dead, O(log n) with no
+    // restructuring, and contains()/iterators skip dead cards. Once dead
+    // cards exceed threshold of the tree, it is rebuilt balanced in one
+    // pass. Turning lazy deletion off compacts immediately.
+    void setLazyDelete(bool enabled, double threshold = 0.25);
+    std::size_t tombstones() const;
     
     // Print
     void print(std::ostream& os) const;
@@ -77,10 +133,11 @@ public:
         friend class CardList;
         iterator(Node* n, const CardList* tree);
         Node* node;
-        const CardList* tree; // needed for successor/predecessor searches when no parent pointer
+        const CardList* tree; // needed to step back from end()
 
-        Node* successor(Node* n) const;
-        Node* predecessor(Node* n) const;
+        // step past tombstones left by lazy deletion
+        void skip_dead_forward();
+        void skip_dead_backward();
     };
 
     // iterator entry points
@@ -88,9 +145,35 @@ public:
     iterator end() const;
     iterator rbegin() const; // returns iterator to largest
     iterator rend() const;   // past-the-begin (nullptr)
+
+    // iterator-based access (saves repeating a search for a known position)
+    iterator find(const Card& card) const;       // end() if not held
+    // Insert next to hint (the card's neighbour on either side, or end() to
+    // append). O(1) when the card goes after the largest or before the
+    // smallest card, so loading a sorted file never walks the tree; other
+    // right hints walk to the hint's neighbour, O(depth), and a wrong hint
+    // costs an ordinary insert. Returns an iterator to the card.
+    iterator insert(iterator hint, const Card& card);
+    // hinted inserts so far that were not O(1) (walked or searched)
+    std::size_t hintWalks() const;
+    // Remove the card at pos; returns an iterator to the next larger card
+    iterator erase(iterator pos);
 };
 
 // Game logic function 
 void playGame(CardList &alice, CardList &bob);
 
+// Game logic without printing: appends every picked card to moves
+// (Alice's picks at even positions, Bob's at odd positions)
+void playGame(CardList &alice, CardList &bob, std::vector<Card> &moves);
+
+// Print recorded moves in the same format playGame(alice, bob) uses
+void printMoves(const std::vector<Card> &moves, std::ostream &os);
+
+// 52-bit hand masks (bit cardIndex(c) set for each card held).
+// toMask returns false if the hand holds a card outside the 52-card deck.
+bool toMask(const CardList &hand, std::uint64_t &mask);
+// Replaces the contents of hand with the cards in mask
+void fromMask(CardList &hand, std::uint64_t mask);
+
 #endif
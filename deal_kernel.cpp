@@ -0,0 +1,214 @@
+// deal_kernel.cpp
+// Author: Owen Kirchner
+// Implementation of the functions declared in deal_kernel.h
+
+#include "deal_kernel.h"
+#include "card.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DEAL_KERNEL_X86 1
+#endif
+
+namespace deal {
+
+namespace {
+
+// one deal at a time, with the bit-scan instructions
+void playScalar(const std::uint64_t* alice, const std::uint64_t* bob, std::size_t n, Outcome* out) {
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint64_t a = alice[i] & DECK_MASK;
+        std::uint64_t b = bob[i] & DECK_MASK;
+        Outcome& o = out[i];
+        o.moveCount = 0;
+        while (true) {
+            std::uint64_t common = a & b;
+            if (common == 0) break;
+            int low = __builtin_ctzll(common);
+            o.moves[o.moveCount++] = static_cast<std::uint8_t>(low);
+            a ^= std::uint64_t(1) << low;
+            b ^= std::uint64_t(1) << low;
+
+            common = a & b;
+            if (common == 0) break;
+            int high = 63 - __builtin_clzll(common);
+            o.moves[o.moveCount++] = static_cast<std::uint8_t>(high);
+            a ^= std::uint64_t(1) << high;
+            b ^= std::uint64_t(1) << high;
+        }
+        o.alice = a;
+        o.bob = b;
+    }
+}
+
+#ifdef DEAL_KERNEL_X86
+
+// Lane driver shared by the vector kernels. Step plays one round (Alice's
+// turn, then Bob's) in every lane, leaving the picked card indices in
+// alicePick/bobPick, or -1 where the player found no match, which ends
+// that lane's game. Inlined into each target-specific entry point so Step
+// is compiled (and inlined) with that entry point's instruction set.
+template <int LANES, typename Step>
+__attribute__((always_inline)) inline void runLanes(const std::uint64_t* alice, const std::uint64_t* bob,
+                                                    std::size_t n, Outcome* out, Step step) {
+    alignas(64) std::uint64_t a[LANES];
+    alignas(64) std::uint64_t b[LANES];
+    alignas(64) std::int64_t alicePick[LANES];
+    alignas(64) std::int64_t bobPick[LANES];
+    std::size_t game[LANES];   // n for an idle lane
+    std::size_t next = 0;
+    int live = 0;
+
+    // load the next deal into lane l; false once there are none left
+    auto refill = [&](int l) {
+        if (next == n) {
+            game[l] = n;
+            a[l] = b[l] = 0;
+            return false;
+        }
+        game[l] = next;
+        a[l] = alice[next] & DECK_MASK;
+        b[l] = bob[next] & DECK_MASK;
+        out[next].moveCount = 0;
+        ++next;
+        return true;
+    };
+    for (int l = 0; l < LANES; ++l) live += refill(l);
+
+    while (live > 0) {
+        step(a, b, alicePick, bobPick);
+        for (int l = 0; l < LANES; ++l) {
+            if (game[l] == n) continue;
+            Outcome& o = out[game[l]];
+            if (alicePick[l] >= 0) o.moves[o.moveCount++] = static_cast<std::uint8_t>(alicePick[l]);
+            if (bobPick[l] >= 0) {
+                o.moves[o.moveCount++] = static_cast<std::uint8_t>(bobPick[l]);
+                continue;
+            }
+            // game over: retire the lane
+            o.alice = a[l];
+            o.bob = b[l];
+            if (!refill(l)) --live;
+        }
+    }
+}
+
+// AVX2 has no 64-bit bit scan: for 0 < x < 2^52, OR-ing x into the mantissa
+// of 2^52 and subtracting 2^52 converts x to a double exactly, and the
+// exponent of that double is the index of x's highest set bit
+__attribute__((target("avx2"))) inline __m256i highBitAvx2(__m256i x) {
+    const __m256i magic = _mm256_set1_epi64x(0x4330000000000000LL); // 2^52
+    __m256d d = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(x, magic)), _mm256_castsi256_pd(magic));
+    __m256i index = _mm256_sub_epi64(_mm256_srli_epi64(_mm256_castpd_si256(d), 52), _mm256_set1_epi64x(1023));
+    // x == 0 gives -1023; report -1 instead
+    return _mm256_or_si256(index, _mm256_cmpeq_epi64(x, _mm256_setzero_si256()));
+}
+
+__attribute__((target("avx2"))) void playAvx2(const std::uint64_t* alice, const std::uint64_t* bob,
+                                              std::size_t n, Outcome* out) {
+    runLanes<4>(alice, bob, n, out, [](std::uint64_t* a, std::uint64_t* b, std::int64_t* alicePick,
+                                        std::int64_t* bobPick) __attribute__((target("avx2"))) {
+        const __m256i one = _mm256_set1_epi64x(1);
+        __m256i va = _mm256_load_si256(reinterpret_cast<const __m256i*>(a));
+        __m256i vb = _mm256_load_si256(reinterpret_cast<const __m256i*>(b));
+
+        // Alice: lowest common card, isolated as common & -common
+        __m256i common = _mm256_and_si256(va, vb);
+        __m256i low = _mm256_and_si256(common, _mm256_sub_epi64(_mm256_setzero_si256(), common));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(alicePick), highBitAvx2(low));
+        va = _mm256_xor_si256(va, low);
+        vb = _mm256_xor_si256(vb, low);
+
+        // Bob: highest common card (a shift by -1 gives 0 for finished lanes)
+        common = _mm256_xor_si256(common, low);
+        __m256i index = highBitAvx2(common);
+        __m256i high = _mm256_sllv_epi64(one, index);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(bobPick), index);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(a), _mm256_xor_si256(va, high));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(b), _mm256_xor_si256(vb, high));
+    });
+}
+
+__attribute__((target("avx512f,avx512cd"))) void playAvx512(const std::uint64_t* alice, const std::uint64_t* bob,
+                                                            std::size_t n, Outcome* out) {
+    runLanes<8>(alice, bob, n, out, [](std::uint64_t* a, std::uint64_t* b, std::int64_t* alicePick,
+                                        std::int64_t* bobPick) __attribute__((target("avx512f,avx512cd"))) {
+        const __m512i one = _mm512_set1_epi64(1);
+        const __m512i top = _mm512_set1_epi64(63);
+        __m512i va = _mm512_load_si512(a);
+        __m512i vb = _mm512_load_si512(b);
+
+        // Alice: lowest common card; its index is 63 - lzcnt (lzcnt(0) = 64 gives -1)
+        __m512i common = _mm512_and_si512(va, vb);
+        __m512i low = _mm512_and_si512(common, _mm512_sub_epi64(_mm512_setzero_si512(), common));
+        _mm512_store_si512(alicePick, _mm512_sub_epi64(top, _mm512_lzcnt_epi64(low)));
+        va = _mm512_xor_si512(va, low);
+        vb = _mm512_xor_si512(vb, low);
+
+        // Bob: highest common card (none in lanes whose common is empty)
+        common = _mm512_xor_si512(common, low);
+        __m512i index = _mm512_sub_epi64(top, _mm512_lzcnt_epi64(common));
+        __m512i high = _mm512_maskz_sllv_epi64(_mm512_test_epi64_mask(common, common), one, index);
+        _mm512_store_si512(bobPick, index);
+        _mm512_store_si512(a, _mm512_xor_si512(va, high));
+        _mm512_store_si512(b, _mm512_xor_si512(vb, high));
+    });
+}
+
+#endif // DEAL_KERNEL_X86
+
+} // namespace
+
+bool supported(Kernel kernel) {
+    switch (kernel) {
+    case Kernel::SCALAR:
+        return true;
+#ifdef DEAL_KERNEL_X86
+    case Kernel::AVX2:
+        return __builtin_cpu_supports("avx2");
+    case Kernel::AVX512:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd");
+#endif
+    default:
+        return false;
+    }
+}
+
+Kernel best() {
+    static const Kernel chosen = supported(Kernel::AVX512) ? Kernel::AVX512
+                               : supported(Kernel::AVX2)   ? Kernel::AVX2
+                                                           : Kernel::SCALAR;
+    return chosen;
+}
+
+const char* name(Kernel kernel) {
+    switch (kernel) {
+    case Kernel::AVX2: return "avx2";
+    case Kernel::AVX512: return "avx512";
+    default: return "scalar";
+    }
+}
+
+void playDeals(const std::uint64_t* alice, const std::uint64_t* bob, std::size_t n, Outcome* out) {
+    playDeals(best(), alice, bob, n, out);
+}
+
+void playDeals(Kernel kernel, const std::uint64_t* alice, const std::uint64_t* bob,
+               std::size_t n, Outcome* out) {
+    if (!supported(kernel)) kernel = Kernel::SCALAR;
+    switch (kernel) {
+#ifdef DEAL_KERNEL_X86
+    case Kernel::AVX2:
+        playAvx2(alice, bob, n, out);
+        return;
+    case Kernel::AVX512:
+        playAvx512(alice, bob, n, out);
+        return;
+#endif
+    default:
+        playScalar(alice, bob, n, out);
+        return;
+    }
+}
+
+} // namespace deal
@@ -0,0 +1,39 @@
+// deal_kernel.h
+// Author: Owen Kirchner
+// Plays many independent deals at once on 52-bit hand masks (see toMask).
+// In mask form a game turn is: common = alice & bob; take the lowest
+// (Alice) or highest (Bob) set bit of common; clear it from both hands.
+// The vector kernels run one deal per 64-bit lane (4 with AVX2, 8 with
+// AVX-512) in lockstep. When a lane's game ends, its outcome is written out
+// and the next deal is loaded into that lane.
+//
+// Results are identical to playGame on the same hands: moves hold card
+// indices with Alice's picks at even positions. Bits above the deck (52+)
+// are ignored.
+
+#ifndef DEAL_KERNEL_H
+#define DEAL_KERNEL_H
+
+#include "outcome.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace deal {
+
+enum class Kernel { SCALAR, AVX2, AVX512 };
+
+// Widest kernel this CPU can run (checked once, at first use)
+Kernel best();
+bool supported(Kernel kernel);
+const char* name(Kernel kernel);
+
+// out[i] receives the outcome of the deal (alice[i], bob[i])
+void playDeals(const std::uint64_t* alice, const std::uint64_t* bob, std::size_t n, Outcome* out);
+// Same with an explicit kernel; an unsupported one falls back to SCALAR
+void playDeals(Kernel kernel, const std::uint64_t* alice, const std::uint64_t* bob,
+               std::size_t n, Outcome* out);
+
+} // namespace deal
+
+#endif
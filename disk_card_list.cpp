@@ -0,0 +1,504 @@
+// disk_card_list.cpp
+// Author: Owen Kirchner
+// Implementation of the classes defined in disk_card_list.h
+
+#include "disk_card_list.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char MAGIC[8] = {'C', 'A', 'R', 'D', 'B', 'P', 'T', '1'};
+constexpr std::size_t MIN_PAGE_SIZE = 64;
+constexpr std::size_t MAX_PAGE_SIZE = 1 << 20;
+constexpr std::size_t PREFETCH_PAGES = 8; // read-ahead window for in-order scans
+constexpr std::size_t ALL_SLOTS = std::numeric_limits<std::size_t>::max();
+
+// page layout: type (u8), unused (u8), count (u16), prev (u32), next (u32),
+// then leaf cards (2 bytes each) or internal children (u32) followed by keys
+constexpr std::size_t NODE_HEADER = 12;
+constexpr std::uint8_t LEAF = 1;
+constexpr std::uint8_t INTERNAL = 2;
+
+std::uint16_t get16(const unsigned char* p) { std::uint16_t v; std::memcpy(&v, p, 2); return v; }
+std::uint32_t get32(const unsigned char* p) { std::uint32_t v; std::memcpy(&v, p, 4); return v; }
+std::uint64_t get64(const unsigned char* p) { std::uint64_t v; std::memcpy(&v, p, 8); return v; }
+void put16(unsigned char* p, std::uint16_t v) { std::memcpy(p, &v, 2); }
+void put32(unsigned char* p, std::uint32_t v) { std::memcpy(p, &v, 4); }
+void put64(unsigned char* p, std::uint64_t v) { std::memcpy(p, &v, 8); }
+
+std::size_t countOf(const unsigned char* p) { return get16(p + 2); }
+void setCount(unsigned char* p, std::size_t n) { put16(p + 2, static_cast<std::uint16_t>(n)); }
+std::uint32_t prevOf(const unsigned char* p) { return get32(p + 4); }
+std::uint32_t nextOf(const unsigned char* p) { return get32(p + 8); }
+void setPrev(unsigned char* p, std::uint32_t v) { put32(p + 4, v); }
+void setNext(unsigned char* p, std::uint32_t v) { put32(p + 8, v); }
+
+Card readCard(const unsigned char* p) {
+    return Card(static_cast<char>(p[0]), static_cast<char>(p[1]));
+}
+void writeCard(unsigned char* p, const Card& c) {
+    p[0] = static_cast<unsigned char>(c.getSuit());
+    p[1] = static_cast<unsigned char>(c.getRank());
+}
+
+// leaf slots
+Card leafKey(const unsigned char* p, std::size_t i) { return readCard(p + NODE_HEADER + 2 * i); }
+void setLeafKey(unsigned char* p, std::size_t i, const Card& c) { writeCard(p + NODE_HEADER + 2 * i, c); }
+
+// internal slots (cap = internal capacity, fixes where the keys start)
+std::uint32_t childOf(const unsigned char* p, std::size_t i) { return get32(p + NODE_HEADER + 4 * i); }
+void setChild(unsigned char* p, std::size_t i, std::uint32_t v) { put32(p + NODE_HEADER + 4 * i, v); }
+Card innerKey(const unsigned char* p, std::size_t cap, std::size_t i) {
+    return readCard(p + NODE_HEADER + 4 * (cap + 1) + 2 * i);
+}
+void setInnerKey(unsigned char* p, std::size_t cap, std::size_t i, const Card& c) {
+    writeCard(p + NODE_HEADER + 4 * (cap + 1) + 2 * i, c);
+}
+
+// first leaf slot whose card is not less than card
+std::size_t leafLowerBound(const unsigned char* p, const Card& card) {
+    std::size_t lo = 0, hi = countOf(p);
+    while (lo < hi) {
+        std::size_t mid = (lo + hi) / 2;
+        if (leafKey(p, mid) < card) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// child to descend into: number of separators <= card
+std::size_t innerUpperBound(const unsigned char* p, std::size_t cap, const Card& card) {
+    std::size_t lo = 0, hi = countOf(p);
+    while (lo < hi) {
+        std::size_t mid = (lo + hi) / 2;
+        if (card < innerKey(p, cap, mid)) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+// A page read back from the file: the type the caller expects, a count
+// that fits, and page numbers inside the file (0 ends a leaf chain)
+bool pageValid(const unsigned char* p, bool leaf, std::size_t capacity, std::uint32_t pageCount) {
+    std::size_t n = countOf(p);
+    if (p[0] != (leaf ? LEAF : INTERNAL) || n > capacity) return false;
+    if (leaf) return prevOf(p) < pageCount && nextOf(p) < pageCount;
+    for (std::size_t i = 0; i <= n; ++i) {
+        std::uint32_t child = childOf(p, i);
+        if (child == 0 || child >= pageCount) return false;
+    }
+    return true;
+}
+
+// stand-in for a damaged page: empty, so lookups and scans stop there
+void clearPage(std::vector<unsigned char>& data, bool leaf) {
+    std::fill(data.begin(), data.end(), 0);
+    data[0] = leaf ? LEAF : INTERNAL;
+}
+
+} // namespace
+
+// Constructor: open an existing list or create an empty one
+DiskCardList::DiskCardList(const std::string& path, std::size_t cachePages, std::size_t requestedPageSize)
+    : fd(-1), failed(false), pageSize(std::clamp(requestedPageSize, MIN_PAGE_SIZE, MAX_PAGE_SIZE)),
+      leafCapacity(0), internalCapacity(0), rootPage(0), firstLeaf(0), lastLeaf(0),
+      pageCount(1), height(1), cardCount(0), headerDirty(false),
+      cacheCapacity(std::max<std::size_t>(cachePages, 4)) {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        failed = true;
+        return;
+    }
+
+    if (st.st_size == 0) {
+        computeCapacities();
+        rootPage = firstLeaf = lastLeaf = allocatePage(true);
+        flush();
+    } else if (!readHeader(static_cast<std::uint64_t>(st.st_size))) {
+        failed = true;
+    }
+}
+
+// Destructor: write everything back
+DiskCardList::~DiskCardList() {
+    if (!failed) flush();
+    if (fd >= 0) ::close(fd);
+}
+
+bool DiskCardList::fail() const { return failed; }
+std::size_t DiskCardList::size() const { return static_cast<std::size_t>(cardCount); }
+
+void DiskCardList::computeCapacities() {
+    leafCapacity = std::min<std::size_t>((pageSize - NODE_HEADER) / 2, 0xffff);
+    // children take 4 bytes each (one more than keys), keys 2
+    internalCapacity = std::min<std::size_t>((pageSize - NODE_HEADER - 4) / 6, 0xffff);
+}
+
+// Header page: magic, page size, root, first/last leaf, page count, height, card count
+bool DiskCardList::readHeader(std::uint64_t fileSize) {
+    std::vector<unsigned char> buf(64);
+    if (::pread(fd, buf.data(), buf.size(), 0) != static_cast<ssize_t>(buf.size())) return false;
+    if (!std::equal(MAGIC, MAGIC + sizeof(MAGIC), buf.begin())) return false;
+    pageSize = get32(&buf[8]);
+    rootPage = get32(&buf[12]);
+    firstLeaf = get32(&buf[16]);
+    lastLeaf = get32(&buf[20]);
+    pageCount = get32(&buf[24]);
+    height = get32(&buf[28]);
+    cardCount = get64(&buf[32]);
+    if (pageSize < MIN_PAGE_SIZE || pageSize > MAX_PAGE_SIZE || height == 0 || height > pageCount) return false;
+    // every page the header names must lie inside the file
+    for (std::uint32_t page : {rootPage, firstLeaf, lastLeaf}) {
+        if (page == 0 || page >= pageCount) return false;
+    }
+    if (fileSize < static_cast<std::uint64_t>(pageCount) * pageSize) return false;
+    computeCapacities();
+    return true;
+}
+
+bool DiskCardList::writeHeader() {
+    std::vector<unsigned char> buf(pageSize, 0);
+    std::copy(MAGIC, MAGIC + sizeof(MAGIC), buf.begin());
+    put32(&buf[8], static_cast<std::uint32_t>(pageSize));
+    put32(&buf[12], rootPage);
+    put32(&buf[16], firstLeaf);
+    put32(&buf[20], lastLeaf);
+    put32(&buf[24], pageCount);
+    put32(&buf[28], height);
+    put64(&buf[32], cardCount);
+    if (::pwrite(fd, buf.data(), buf.size(), 0) != static_cast<ssize_t>(buf.size())) return false;
+    headerDirty = false;
+    return true;
+}
+
+// A page that cannot be written stays dirty in the cache; the header is only
+// written once every page it points to is on disk
+bool DiskCardList::flush() {
+    if (failed) return false;
+    for (auto& entry : frames) {
+        if (entry.second->dirty && !writeFrame(*entry.second)) failed = true;
+    }
+    if (!failed && !writeHeader()) failed = true;
+    return !failed;
+}
+
+// page cache
+
+bool DiskCardList::writeFrame(Frame& frame) const {
+    off_t offset = static_cast<off_t>(frame.page) * static_cast<off_t>(pageSize);
+    if (::pwrite(fd, frame.data.data(), pageSize, offset) != static_cast<ssize_t>(pageSize)) return false;
+    frame.dirty = false;
+    return true;
+}
+
+// drop least recently used unpinned pages until there is room for one more
+void DiskCardList::evictIfFull() const {
+    auto victim = lru.end();
+    while (frames.size() >= cacheCapacity && victim != lru.begin()) {
+        --victim;
+        Frame& frame = *frames.at(*victim);
+        if (frame.pins > 0) continue;
+        if (frame.dirty && !writeFrame(frame)) {
+            failed = true; // keep the page rather than lose its changes
+            continue;
+        }
+        auto erased = victim;
+        ++victim;
+        frames.erase(*erased);
+        lru.erase(erased);
+    }
+}
+
+DiskCardList::Frame* DiskCardList::fetch(std::uint32_t page, bool leaf) const {
+    auto found = frames.find(page);
+    if (found != frames.end()) {
+        Frame* frame = found->second.get();
+        lru.splice(lru.begin(), lru, frame->lruPos);
+        if (frame->data[0] != (leaf ? LEAF : INTERNAL)) {
+            failed = true; // a damaged parent pointed at the wrong kind of page
+            clearPage(frame->data, leaf);
+        }
+        return frame;
+    }
+
+    evictIfFull();
+    auto frame = std::make_unique<Frame>();
+    frame->page = page;
+    frame->dirty = false;
+    frame->pins = 0;
+    frame->data.assign(pageSize, 0);
+    off_t offset = static_cast<off_t>(page) * static_cast<off_t>(pageSize);
+    bool ok = page != 0 && page < pageCount &&
+              ::pread(fd, frame->data.data(), pageSize, offset) == static_cast<ssize_t>(pageSize) &&
+              pageValid(frame->data.data(), leaf, leaf ? leafCapacity : internalCapacity, pageCount);
+    if (!ok) {
+        failed = true;
+        clearPage(frame->data, leaf);
+    }
+    lru.push_front(page);
+    frame->lruPos = lru.begin();
+    Frame* raw = frame.get();
+    frames.emplace(page, std::move(frame));
+    return raw;
+}
+
+DiskCardList::PageRef DiskCardList::pin(std::uint32_t page, bool leaf) const {
+    return PageRef(this, fetch(page, leaf));
+}
+
+std::uint32_t DiskCardList::allocatePage(bool leaf) {
+    std::uint32_t page = pageCount++;
+    headerDirty = true;
+    evictIfFull();
+    auto frame = std::make_unique<Frame>();
+    frame->page = page;
+    frame->dirty = true;
+    frame->pins = 0;
+    frame->data.assign(pageSize, 0);
+    frame->data[0] = leaf ? LEAF : INTERNAL;
+    lru.push_front(page);
+    frame->lruPos = lru.begin();
+    frames.emplace(page, std::move(frame));
+    return page;
+}
+
+// ask the kernel to start reading the leaves after this one
+void DiskCardList::prefetchAfter(std::uint32_t leaf) const {
+    std::uint32_t next = nextOf(fetch(leaf, true)->data.data());
+    if (next == 0 || frames.count(next)) return;
+    // leaves written in order sit next to each other, so read a window
+    std::size_t pages = (next == leaf + 1) ? PREFETCH_PAGES : 1;
+    ::posix_fadvise(fd, static_cast<off_t>(next) * static_cast<off_t>(pageSize),
+                    static_cast<off_t>(pages * pageSize), POSIX_FADV_WILLNEED);
+}
+
+DiskCardList::PageRef::PageRef(const DiskCardList* l, Frame* f) : list(l), frame(f) {
+    ++frame->pins;
+}
+DiskCardList::PageRef::~PageRef() {
+    --frame->pins;
+}
+unsigned char* DiskCardList::PageRef::data() const { return frame->data.data(); }
+void DiskCardList::PageRef::markDirty() const { frame->dirty = true; }
+
+// tree operations
+
+std::uint32_t DiskCardList::findLeaf(const Card& card) const {
+    std::uint32_t page = rootPage;
+    for (std::uint32_t level = height; level > 1; --level) {
+        PageRef ref = pin(page, false);
+        page = childOf(ref.data(), innerUpperBound(ref.data(), internalCapacity, card));
+    }
+    return page;
+}
+
+bool DiskCardList::contains(const Card& card) const {
+    if (failed) return false;
+    PageRef ref = pin(findLeaf(card), true);
+    std::size_t pos = leafLowerBound(ref.data(), card);
+    return pos < countOf(ref.data()) && leafKey(ref.data(), pos) == card;
+}
+
+void DiskCardList::insert(const Card& card) {
+    if (failed) return;
+    Card separator;
+    std::uint32_t right = 0;
+    bool added = false;
+    if (insertInto(rootPage, height, card, separator, right, added)) {
+        // the root split: grow the tree by one level
+        std::uint32_t newRoot = allocatePage(false);
+        PageRef ref = pin(newRoot, false);
+        setCount(ref.data(), 1);
+        setChild(ref.data(), 0, rootPage);
+        setChild(ref.data(), 1, right);
+        setInnerKey(ref.data(), internalCapacity, 0, separator);
+        rootPage = newRoot;
+        ++height;
+    }
+    if (added) {
+        ++cardCount;
+        headerDirty = true;
+    }
+}
+
+// Insert below page; returns true if page split, with the new right sibling
+// and the separator (smallest card under the right sibling) to add above
+bool DiskCardList::insertInto(std::uint32_t page, std::uint32_t level, const Card& card,
+                              Card& separator, std::uint32_t& rightPage, bool& added) {
+    PageRef ref = pin(page, level == 1);
+    unsigned char* p = ref.data();
+    std::size_t n = countOf(p);
+
+    if (level == 1) {
+        std::size_t pos = leafLowerBound(p, card);
+        if (pos < n && !(card < leafKey(p, pos))) return false; // no duplicates
+        added = true;
+        ref.markDirty();
+
+        std::vector<Card> cards;
+        cards.reserve(n + 1);
+        for (std::size_t i = 0; i < n; ++i) cards.push_back(leafKey(p, i));
+        cards.insert(cards.begin() + pos, card);
+        if (cards.size() <= leafCapacity) {
+            for (std::size_t i = pos; i < cards.size(); ++i) setLeafKey(p, i, cards[i]);
+            setCount(p, cards.size());
+            return false;
+        }
+
+        // split: left half stays, right half moves to a new leaf
+        std::uint32_t newPage = allocatePage(true);
+        PageRef newRef = pin(newPage, true);
+        unsigned char* q = newRef.data();
+        std::size_t keep = cards.size() / 2;
+        for (std::size_t i = 0; i < keep; ++i) setLeafKey(p, i, cards[i]);
+        for (std::size_t i = keep; i < cards.size(); ++i) setLeafKey(q, i - keep, cards[i]);
+        setCount(p, keep);
+        setCount(q, cards.size() - keep);
+
+        std::uint32_t next = nextOf(p);
+        setPrev(q, page);
+        setNext(q, next);
+        setNext(p, newPage);
+        if (next != 0) {
+            PageRef nextRef = pin(next, true);
+            setPrev(nextRef.data(), newPage);
+            nextRef.markDirty();
+        } else {
+            lastLeaf = newPage;
+        }
+        separator = cards[keep];
+        rightPage = newPage;
+        return true;
+    }
+
+    std::size_t idx = innerUpperBound(p, internalCapacity, card);
+    Card childSeparator;
+    std::uint32_t childRight = 0;
+    if (!insertInto(childOf(p, idx), level - 1, card, childSeparator, childRight, added)) return false;
+
+    // the child split: add its separator and new sibling here
+    ref.markDirty();
+    std::vector<Card> keys;
+    std::vector<std::uint32_t> children;
+    keys.reserve(n + 1);
+    children.reserve(n + 2);
+    for (std::size_t i = 0; i < n; ++i) keys.push_back(innerKey(p, internalCapacity, i));
+    for (std::size_t i = 0; i <= n; ++i) children.push_back(childOf(p, i));
+    keys.insert(keys.begin() + idx, childSeparator);
+    children.insert(children.begin() + idx + 1, childRight);
+
+    if (keys.size() <= internalCapacity) {
+        for (std::size_t i = idx; i < keys.size(); ++i) setInnerKey(p, internalCapacity, i, keys[i]);
+        for (std::size_t i = idx + 1; i < children.size(); ++i) setChild(p, i, children[i]);
+        setCount(p, keys.size());
+        return false;
+    }
+
+    // split: the middle key moves up, the keys either side stay below
+    std::uint32_t newPage = allocatePage(false);
+    PageRef newRef = pin(newPage, false);
+    unsigned char* q = newRef.data();
+    std::size_t mid = keys.size() / 2;
+    for (std::size_t i = 0; i < mid; ++i) setInnerKey(p, internalCapacity, i, keys[i]);
+    for (std::size_t i = 0; i <= mid; ++i) setChild(p, i, children[i]);
+    setCount(p, mid);
+    for (std::size_t i = mid + 1; i < keys.size(); ++i) setInnerKey(q, internalCapacity, i - mid - 1, keys[i]);
+    for (std::size_t i = mid + 1; i < children.size(); ++i) setChild(q, i - mid - 1, children[i]);
+    setCount(q, keys.size() - mid - 1);
+    separator = keys[mid];
+    rightPage = newPage;
+    return true;
+}
+
+void DiskCardList::remove(const Card& card) {
+    if (failed) return;
+    PageRef ref = pin(findLeaf(card), true);
+    unsigned char* p = ref.data();
+    std::size_t n = countOf(p);
+    std::size_t pos = leafLowerBound(p, card);
+    if (pos == n || !(leafKey(p, pos) == card)) return;
+    for (std::size_t i = pos + 1; i < n; ++i) setLeafKey(p, i - 1, leafKey(p, i));
+    setCount(p, n - 1);
+    ref.markDirty();
+    --cardCount;
+    headerDirty = true;
+}
+
+// iterator implementation
+
+DiskCardList::iterator DiskCardList::firstFrom(std::uint32_t leaf, std::size_t slot) const {
+    while (leaf != 0) {
+        PageRef ref = pin(leaf, true);
+        if (slot < countOf(ref.data())) return iterator(this, leaf, slot);
+        leaf = nextOf(ref.data());
+        slot = 0;
+        if (leaf != 0) prefetchAfter(leaf);
+    }
+    return end();
+}
+
+DiskCardList::iterator DiskCardList::lastFrom(std::uint32_t leaf, std::size_t endSlot) const {
+    while (leaf != 0) {
+        PageRef ref = pin(leaf, true);
+        std::size_t n = std::min(endSlot, countOf(ref.data()));
+        if (n > 0) return iterator(this, leaf, n - 1);
+        leaf = prevOf(ref.data());
+        endSlot = ALL_SLOTS;
+    }
+    return end();
+}
+
+DiskCardList::iterator::iterator() : list(nullptr), leaf(0), slot(0) {}
+
+DiskCardList::iterator::iterator(const DiskCardList* l, std::uint32_t lf, std::size_t s)
+    : list(l), leaf(lf), slot(s) {
+    if (leaf != 0) current = leafKey(list->fetch(leaf, true)->data.data(), slot);
+}
+
+DiskCardList::iterator::reference DiskCardList::iterator::operator*() const { return current; }
+DiskCardList::iterator::pointer DiskCardList::iterator::operator->() const { return &current; }
+
+DiskCardList::iterator& DiskCardList::iterator::operator++() {
+    if (leaf != 0) *this = list->firstFrom(leaf, slot + 1);
+    return *this;
+}
+DiskCardList::iterator DiskCardList::iterator::operator++(int) {
+    iterator tmp = *this;
+    ++(*this);
+    return tmp;
+}
+
+// pre-decrement: from end() move to the largest card
+DiskCardList::iterator& DiskCardList::iterator::operator--() {
+    if (leaf == 0) *this = list->lastFrom(list->lastLeaf, ALL_SLOTS);
+    else *this = list->lastFrom(leaf, slot);
+    return *this;
+}
+DiskCardList::iterator DiskCardList::iterator::operator--(int) {
+    iterator tmp = *this;
+    --(*this);
+    return tmp;
+}
+
+bool DiskCardList::iterator::operator==(const iterator& other) const {
+    return leaf == other.leaf && (leaf == 0 || slot == other.slot);
+}
+bool DiskCardList::iterator::operator!=(const iterator& other) const {
+    return !(*this == other);
+}
+
+DiskCardList::iterator DiskCardList::begin() const {
+    return failed ? end() : firstFrom(firstLeaf, 0);
+}
+DiskCardList::iterator DiskCardList::end() const { return iterator(this, 0, 0); }
+DiskCardList::iterator DiskCardList::rbegin() const {
+    return failed ? end() : lastFrom(lastLeaf, ALL_SLOTS);
+}
+DiskCardList::iterator DiskCardList::rend() const { return end(); }
@@ -0,0 +1,156 @@
+// disk_card_list.h
+// Author: Owen Kirchner
+// File-backed ordered set of cards for hands that do not fit in memory.
+// Same insert/remove/contains and bidirectional iterator API as CardList,
+// stored as a B+-tree of fixed-size pages in a single file:
+//   - page 0 is the header (root, leaf chain ends, counts, page size)
+//   - leaves hold sorted cards and are chained both ways for iteration
+//   - internal pages hold separators and child page numbers
+// Pages are read through a bounded LRU page cache; in-order scans ask the
+// kernel to read ahead along the leaf chain. Reopening an existing file
+// only reads its header, so startup does not depend on the hand size; each
+// page is checked (type, count, page numbers) when it is first read.
+//
+// remove() never merges pages: underfull (even empty) leaves stay in the
+// chain and are skipped, which keeps removal to a single root-to-leaf pass.
+
+#ifndef DISK_CARD_LIST_H
+#define DISK_CARD_LIST_H
+
+#include "card.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class DiskCardList {
+public:
+    static constexpr std::size_t DEFAULT_PAGE_SIZE = 4096;
+    static constexpr std::size_t DEFAULT_CACHE_PAGES = 256;
+
+    // Opens path, creating an empty list there if the file does not exist.
+    // pageSize only applies to new files (64 bytes to 1 MiB); existing files
+    // keep the page size they were created with.
+    explicit DiskCardList(const std::string& path,
+                          std::size_t cachePages = DEFAULT_CACHE_PAGES,
+                          std::size_t pageSize = DEFAULT_PAGE_SIZE);
+    ~DiskCardList(); // flushes
+    DiskCardList(const DiskCardList&) = delete;
+    DiskCardList& operator=(const DiskCardList&) = delete;
+
+    // true if the file could not be opened, is not a card list, turned out
+    // to be damaged, or a page could not be written. A failed list reads as
+    // empty, ignores changes and writes nothing more to the file.
+    bool fail() const;
+
+    void insert(const Card& card);
+    void remove(const Card& card);
+    bool contains(const Card& card) const;
+    std::size_t size() const;
+
+    // Write dirty pages and the header back to the file; false on failure
+    bool flush();
+
+    // Bidirectional iterator (dereferences to a copy of the card)
+    class iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Card;
+        using reference = const Card&;
+        using pointer = const Card*;
+        using difference_type = std::ptrdiff_t;
+
+        iterator();
+        reference operator*() const;
+        pointer operator->() const;
+
+        iterator& operator++();
+        iterator operator++(int);
+        iterator& operator--();
+        iterator operator--(int);
+
+        bool operator==(const iterator& other) const;
+        bool operator!=(const iterator& other) const;
+
+    private:
+        friend class DiskCardList;
+        iterator(const DiskCardList* list, std::uint32_t leaf, std::size_t slot);
+        const DiskCardList* list;
+        std::uint32_t leaf;   // 0 for end()/rend()
+        std::size_t slot;
+        Card current;         // copy, so dereferencing never touches the cache
+    };
+
+    iterator begin() const;
+    iterator end() const;
+    iterator rbegin() const; // largest
+    iterator rend() const;   // past-the-begin (same as end())
+
+private:
+    struct Frame {
+        std::uint32_t page;
+        bool dirty;
+        int pins;
+        std::vector<unsigned char> data;
+        std::list<std::uint32_t>::iterator lruPos;
+    };
+
+    // pinned page: stays cached while the reference lives
+    class PageRef {
+    public:
+        PageRef(const DiskCardList* list, Frame* frame);
+        ~PageRef();
+        PageRef(const PageRef&) = delete;
+        PageRef& operator=(const PageRef&) = delete;
+        unsigned char* data() const;
+        void markDirty() const;
+    private:
+        const DiskCardList* list;
+        Frame* frame;
+    };
+
+    int fd;
+    mutable bool failed;
+    std::size_t pageSize;
+    std::size_t leafCapacity;
+    std::size_t internalCapacity;
+    std::uint32_t rootPage;
+    std::uint32_t firstLeaf;
+    std::uint32_t lastLeaf;
+    std::uint32_t pageCount;
+    std::uint32_t height;       // 1 = the root is a leaf
+    std::uint64_t cardCount;
+    bool headerDirty;
+
+    std::size_t cacheCapacity;
+    mutable std::unordered_map<std::uint32_t, std::unique_ptr<Frame>> frames;
+    mutable std::list<std::uint32_t> lru; // most recently used first
+
+    // page cache
+    // leaf: the page type the caller expects to find
+    Frame* fetch(std::uint32_t page, bool leaf) const;
+    PageRef pin(std::uint32_t page, bool leaf) const;
+    std::uint32_t allocatePage(bool leaf);
+    void evictIfFull() const;
+    bool writeFrame(Frame& frame) const;
+    void prefetchAfter(std::uint32_t leaf) const;
+
+    bool readHeader(std::uint64_t fileSize);
+    bool writeHeader();
+    void computeCapacities();
+
+    // tree helpers
+    std::uint32_t findLeaf(const Card& card) const;
+    bool insertInto(std::uint32_t page, std::uint32_t level, const Card& card,
+                    Card& separator, std::uint32_t& rightPage, bool& added);
+    // first card at or after (leaf, slot) / last card before (leaf, endSlot),
+    // following the leaf chain past empty leaves
+    iterator firstFrom(std::uint32_t leaf, std::size_t slot) const;
+    iterator lastFrom(std::uint32_t leaf, std::size_t endSlot) const;
+};
+
+#endif
@@ -0,0 +1,219 @@
+// game_client.cpp
+// Author: Owen Kirchner
+// Load generator for game_server: sends random deals over one or more
+// connections, keeping a fixed number of requests in flight on each, and
+// reports throughput and latency percentiles.
+
+#include "card.h"
+#include "card_list.h"
+#include "game_protocol.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+namespace {
+
+struct Options {
+  const char* path = nullptr;
+  unsigned long long requests = 100000;
+  unsigned depth = 32;
+  unsigned connections = 1;
+  unsigned seed = 1;
+  unsigned long long distinct = 0; // draw deals from a pool this size (0 = all random)
+  bool verify = false;
+};
+
+struct InFlight {
+  protocol::Request req;
+  Clock::time_point sent;
+};
+
+struct Connection {
+  int fd = -1;
+  deque<InFlight> inFlight;
+  vector<unsigned char> out;
+  size_t outPos = 0;
+  vector<unsigned char> in;
+};
+
+// true if arg is --name=...; bad is set when the value is not a number
+bool parseFlag(const string& arg, const char* name, unsigned long long& value, bool& bad) {
+  string prefix = string("--") + name + "=";
+  if (arg.compare(0, prefix.size(), prefix) != 0) return false;
+  const char* first = arg.data() + prefix.size();
+  const char* last = arg.data() + arg.size();
+  auto [end, ec] = from_chars(first, last, value);
+  bad = bad || first == last || ec != errc() || end != last;
+  return true;
+}
+
+int connectTo(const char* path) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) return -1;
+  if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// play the same deal locally and compare with the server's answer
+bool matchesLocal(const protocol::Request& req, const protocol::Response& res) {
+  CardList alice, bob;
+  vector<Card> moves;
+  fromMask(alice, req.alice);
+  fromMask(bob, req.bob);
+  playGame(alice, bob, moves);
+  uint64_t a, b;
+  toMask(alice, a);
+  toMask(bob, b);
+  if (a != res.alice || b != res.bob || moves.size() != res.moveCount) return false;
+  for (size_t i = 0; i < moves.size(); ++i) {
+    if (cardIndex(moves[i]) != res.moves[i]) return false;
+  }
+  return true;
+}
+
+double percentile(const vector<double>& sorted, double p) {
+  if (sorted.empty()) return 0;
+  size_t idx = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+  return sorted[min(idx, sorted.size() - 1)];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  bool badArgs = false;
+  for (int i = 1; i < argc; ++i) {
+    string arg = argv[i];
+    unsigned long long v = 0;
+    if (parseFlag(arg, "requests", v, badArgs)) opt.requests = v;
+    else if (parseFlag(arg, "depth", v, badArgs)) opt.depth = static_cast<unsigned>(max(1ull, v));
+    else if (parseFlag(arg, "connections", v, badArgs)) opt.connections = static_cast<unsigned>(max(1ull, v));
+    else if (parseFlag(arg, "seed", v, badArgs)) opt.seed = static_cast<unsigned>(v);
+    else if (parseFlag(arg, "distinct", v, badArgs)) opt.distinct = v;
+    else if (arg == "--verify") opt.verify = true;
+    else opt.path = argv[i];
+  }
+  if (opt.path == nullptr || badArgs) {
+    cout << "Usage: " << argv[0] << " <socket path> [--requests=N] [--depth=N] [--connections=N] [--seed=N] [--distinct=N] [--verify]" << endl;
+    return 1;
+  }
+
+  vector<Connection> conns(opt.connections);
+  for (auto& conn : conns) {
+    conn.fd = connectTo(opt.path);
+    if (conn.fd < 0) {
+      perror(opt.path);
+      return 1;
+    }
+  }
+
+  mt19937_64 rng(opt.seed);
+  // a bounded pool of deals makes repeats (and so server cache hits) likely
+  vector<protocol::Request> pool(opt.distinct);
+  for (auto& req : pool) req = protocol::Request{rng() & DECK_MASK, rng() & DECK_MASK};
+  vector<double> latencies;
+  latencies.reserve(opt.requests);
+  unsigned long long sent = 0, received = 0, mismatches = 0;
+  vector<pollfd> pfds(conns.size());
+  unsigned char reqBuf[protocol::REQUEST_SIZE];
+
+  Clock::time_point start = Clock::now();
+  while (received < opt.requests) {
+    // top up every connection to the pipeline depth
+    for (auto& conn : conns) {
+      while (conn.inFlight.size() < opt.depth && sent < opt.requests) {
+        protocol::Request req = pool.empty() ? protocol::Request{rng() & DECK_MASK, rng() & DECK_MASK}
+                                             : pool[rng() % pool.size()];
+        protocol::encodeRequest(req, reqBuf);
+        conn.out.insert(conn.out.end(), reqBuf, reqBuf + protocol::REQUEST_SIZE);
+        conn.inFlight.push_back(InFlight{req, Clock::now()});
+        ++sent;
+      }
+    }
+
+    for (size_t i = 0; i < conns.size(); ++i) {
+      pfds[i].fd = conns[i].fd;
+      pfds[i].events = POLLIN | (conns[i].outPos < conns[i].out.size() ? POLLOUT : 0);
+      pfds[i].revents = 0;
+    }
+    if (poll(pfds.data(), pfds.size(), -1) < 0) {
+      if (errno == EINTR) continue;
+      perror("poll");
+      return 1;
+    }
+
+    for (size_t i = 0; i < conns.size(); ++i) {
+      Connection& conn = conns[i];
+      if (pfds[i].revents & POLLOUT) {
+        ssize_t n = write(conn.fd, conn.out.data() + conn.outPos, conn.out.size() - conn.outPos);
+        if (n > 0) conn.outPos += static_cast<size_t>(n);
+        if (conn.outPos == conn.out.size()) {
+          conn.out.clear();
+          conn.outPos = 0;
+        }
+      }
+      if (pfds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+        unsigned char buf[64 * 1024];
+        ssize_t n = read(conn.fd, buf, sizeof(buf));
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+          cerr << "Server closed the connection" << endl;
+          return 1;
+        }
+        if (n < 0) continue;
+        conn.in.insert(conn.in.end(), buf, buf + n);
+
+        Clock::time_point now = Clock::now();
+        size_t pos = 0;
+        protocol::Response res;
+        while (size_t used = protocol::decodeResponse(conn.in.data() + pos, conn.in.size() - pos, res)) {
+          pos += used;
+          const InFlight& req = conn.inFlight.front();
+          latencies.push_back(chrono::duration<double, micro>(now - req.sent).count());
+          if (opt.verify && !matchesLocal(req.req, res)) ++mismatches;
+          conn.inFlight.pop_front();
+          ++received;
+        }
+        conn.in.erase(conn.in.begin(), conn.in.begin() + pos);
+      }
+    }
+  }
+  double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+  for (auto& conn : conns) close(conn.fd);
+
+  sort(latencies.begin(), latencies.end());
+  cout << fixed << setprecision(1);
+  cout << "Requests:    " << received << " (" << opt.connections << " connections, depth " << opt.depth << ")" << endl;
+  cout << "Throughput:  " << received / seconds << " req/s" << endl;
+  cout << "Latency us:  p50 " << percentile(latencies, 50)
+       << "  p90 " << percentile(latencies, 90)
+       << "  p99 " << percentile(latencies, 99)
+       << "  p99.9 " << percentile(latencies, 99.9)
+       << "  max " << (latencies.empty() ? 0 : latencies.back()) << endl;
+  if (opt.verify) cout << "Mismatches:  " << mismatches << endl;
+  return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+// game_protocol.cpp
+// Author: Owen Kirchner
+// Implementation of the wire format declared in game_protocol.h
+
+#include "game_protocol.h"
+
+namespace protocol {
+
+// explicit little-endian so the format does not depend on the host
+void putU64(unsigned char* out, std::uint64_t v) {
+    for (int i = 0; i < 8; ++i) out[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+std::uint64_t getU64(const unsigned char* in) {
+    std::uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v |= std::uint64_t(in[i]) << (8 * i);
+    return v;
+}
+
+void encodeRequest(const Request& req, unsigned char* out) {
+    putU64(out, req.alice);
+    putU64(out + 8, req.bob);
+}
+
+Request decodeRequest(const unsigned char* in) {
+    return Request{getU64(in), getU64(in + 8)};
+}
+
+void encodeResponse(const Response& res, std::vector<unsigned char>& out) {
+    std::size_t base = out.size();
+    out.resize(base + RESPONSE_FIXED_SIZE + res.moveCount);
+    unsigned char* p = out.data() + base;
+    *p++ = res.moveCount;
+    for (std::size_t i = 0; i < res.moveCount; ++i) *p++ = res.moves[i];
+    putU64(p, res.alice);
+    putU64(p + 8, res.bob);
+}
+
+std::size_t decodeResponse(const unsigned char* in, std::size_t len, Response& res) {
+    if (len < 1) return 0;
+    std::size_t n = in[0];
+    if (n > MAX_MOVES) n = MAX_MOVES; // malformed; keep the copy in bounds
+    std::size_t total = RESPONSE_FIXED_SIZE + in[0];
+    if (len < total) return 0;
+    res.moveCount = static_cast<std::uint8_t>(n);
+    for (std::size_t i = 0; i < n; ++i) res.moves[i] = in[1 + i];
+    res.alice = getU64(in + 1 + in[0]);
+    res.bob = getU64(in + 9 + in[0]);
+    return total;
+}
+
+} // namespace protocol
@@ -0,0 +1,53 @@
+// game_protocol.h
+// Author: Owen Kirchner
+// Wire format shared by game_server and game_client
+//
+// Request  (16 bytes): alice mask (u64 LE), bob mask (u64 LE)
+// Response (17 + n bytes): move count n (u8), n card indices (u8 each,
+//          Alice's picks at even positions), alice final mask (u64 LE),
+//          bob final mask (u64 LE)
+//
+// Masks use bit cardIndex(c) for every card held. Requests and responses are
+// not framed otherwise, so a client may pipeline any number of requests and
+// the server answers them in order.
+
+#ifndef GAME_PROTOCOL_H
+#define GAME_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace protocol {
+
+constexpr std::size_t REQUEST_SIZE = 16;
+constexpr std::size_t RESPONSE_FIXED_SIZE = 17; // count byte + two masks
+constexpr std::size_t MAX_MOVES = 52;
+
+struct Request {
+    std::uint64_t alice;
+    std::uint64_t bob;
+};
+
+struct Response {
+    std::uint8_t moveCount;
+    std::uint8_t moves[MAX_MOVES];
+    std::uint64_t alice;
+    std::uint64_t bob;
+};
+
+void putU64(unsigned char* out, std::uint64_t v);
+std::uint64_t getU64(const unsigned char* in);
+
+// Requests: fixed size
+void encodeRequest(const Request& req, unsigned char* out);
+Request decodeRequest(const unsigned char* in);
+
+// Responses: appended to out; decodeResponse returns the number of bytes
+// consumed, or 0 if [in, in + len) does not yet hold a full response
+void encodeResponse(const Response& res, std::vector<unsigned char>& out);
+std::size_t decodeResponse(const unsigned char* in, std::size_t len, Response& res);
+
+} // namespace protocol
+
+#endif
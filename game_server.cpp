@@ -0,0 +1,295 @@
+// game_server.cpp
+// Author: Owen Kirchner
+// Long-running daemon that plays deals sent over a Unix domain socket.
+// Each request carries two hands (see game_protocol.h); the server plays
+// them with playGame and answers with the move list and final hands.
+// A single epoll loop handles every connection, and all complete requests
+// in a read are answered in one batch so clients can pipeline freely.
+// A client may half-close once it has sent everything; its remaining
+// responses are still delivered before the connection is closed.
+// Repeated deals are answered from an OutcomeCache (optionally persisted
+// with --cache=<file>) without replaying them.
+
+#include "card.h"
+#include "card_list.h"
+#include "game_protocol.h"
+#include "outcome_cache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+constexpr size_t READ_CHUNK = 64 * 1024;
+constexpr size_t MAX_PENDING_OUTPUT = 1024 * 1024; // stop reading past this until flushed
+constexpr int MAX_EVENTS = 64;
+constexpr size_t DEFAULT_CACHE_SIZE = 1 << 16;
+
+volatile sig_atomic_t stopRequested = 0;
+
+void onSignal(int) { stopRequested = 1; }
+
+// per-connection buffers; kept for the life of the connection so their
+// capacity is reused by every request on it
+struct Connection {
+  int fd = -1;
+  vector<unsigned char> in;
+  vector<unsigned char> out;
+  size_t outPos = 0;
+  uint32_t events = 0;
+  bool peerClosed = false; // read side hit EOF; close once out is drained
+};
+
+// hands and move buffer shared by every request (the loop is single-threaded)
+struct Engine {
+  CardList alice;
+  CardList bob;
+  vector<Card> moves;
+  Outcome outcome;
+  OutcomeCache* cache = nullptr;
+  unsigned long long served = 0;
+
+  void serve(const protocol::Request& req, protocol::Response& res) {
+    uint64_t a = req.alice & DECK_MASK, b = req.bob & DECK_MASK;
+    if (cache == nullptr || !cache->lookup(a, b, outcome)) {
+      fromMask(alice, a);
+      fromMask(bob, b);
+      moves.clear();
+      playGame(alice, bob, moves);
+
+      outcome.moveCount = static_cast<uint8_t>(moves.size());
+      for (size_t i = 0; i < moves.size(); ++i) outcome.moves[i] = static_cast<uint8_t>(cardIndex(moves[i]));
+      toMask(alice, outcome.alice);
+      toMask(bob, outcome.bob);
+      if (cache) cache->store(a, b, outcome);
+    }
+
+    res.moveCount = outcome.moveCount;
+    copy(outcome.moves, outcome.moves + outcome.moveCount, res.moves);
+    res.alice = outcome.alice;
+    res.bob = outcome.bob;
+    ++served;
+  }
+};
+
+bool setEvents(int epfd, Connection& conn, uint32_t events) {
+  if (events == conn.events) return true;
+  epoll_event ev{};
+  ev.events = events;
+  ev.data.fd = conn.fd;
+  if (epoll_ctl(epfd, EPOLL_CTL_MOD, conn.fd, &ev) < 0) return false;
+  conn.events = events;
+  return true;
+}
+
+// write as much pending output as the socket takes; false on a dead peer
+bool flush(Connection& conn) {
+  while (conn.outPos < conn.out.size()) {
+    ssize_t n = write(conn.fd, conn.out.data() + conn.outPos, conn.out.size() - conn.outPos);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+      return false;
+    }
+    conn.outPos += static_cast<size_t>(n);
+  }
+  conn.out.clear();
+  conn.outPos = 0;
+  return true;
+}
+
+size_t pendingOutput(const Connection& conn) {
+  return conn.out.size() - conn.outPos;
+}
+
+// answer every complete request buffered so far, in order
+void serveBuffered(Connection& conn, Engine& engine) {
+  size_t pos = 0;
+  protocol::Response res;
+  while (conn.in.size() - pos >= protocol::REQUEST_SIZE) {
+    engine.serve(protocol::decodeRequest(conn.in.data() + pos), res);
+    protocol::encodeResponse(res, conn.out);
+    pos += protocol::REQUEST_SIZE;
+  }
+  // keep a trailing partial request for the next read
+  conn.in.erase(conn.in.begin(), conn.in.begin() + pos);
+}
+
+// read and answer requests until the socket is empty, the peer half-closes
+// or the unsent output passes MAX_PENDING_OUTPUT; false on a dead peer
+bool readAndServe(Connection& conn, Engine& engine) {
+  // each chunk is answered before the next is read, so out grows as we go
+  // and the backpressure check bounds both buffers
+  while (!conn.peerClosed && pendingOutput(conn) <= MAX_PENDING_OUTPUT) {
+    size_t base = conn.in.size();
+    conn.in.resize(base + READ_CHUNK);
+    ssize_t n = read(conn.fd, conn.in.data() + base, READ_CHUNK);
+    if (n < 0) {
+      conn.in.resize(base);
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+      return false;
+    }
+    conn.in.resize(base + static_cast<size_t>(n));
+    if (n == 0) conn.peerClosed = true;
+    serveBuffered(conn, engine);
+  }
+  return flush(conn);
+}
+
+int listenOn(const char* path) {
+  sockaddr_un addr{};
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    cerr << "Socket path too long: " << path << endl;
+    return -1;
+  }
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    perror("socket");
+    return -1;
+  }
+  unlink(path);
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0) {
+    perror(path);
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const char* path = nullptr;
+  string cachePath;
+  size_t cacheSize = DEFAULT_CACHE_SIZE;
+  bool badArgs = false;
+  for (int i = 1; i < argc; ++i) {
+    string arg = argv[i];
+    if (arg.rfind("--cache=", 0) == 0) {
+      cachePath = arg.substr(8);
+    } else if (arg.rfind("--cache-size=", 0) == 0) {
+      const char* first = arg.data() + 13;
+      const char* last = arg.data() + arg.size();
+      auto [end, ec] = from_chars(first, last, cacheSize);
+      badArgs = badArgs || first == last || ec != errc() || end != last;
+    } else {
+      path = argv[i];
+    }
+  }
+  if (path == nullptr || badArgs) {
+    cout << "Usage: " << argv[0] << " <socket path> [--cache=<file>] [--cache-size=N]" << endl;
+    return 1;
+  }
+
+  struct sigaction sa{};
+  sa.sa_handler = onSignal; // no SA_RESTART: epoll_wait must return on a signal
+  sigaction(SIGINT, &sa, nullptr);
+  sigaction(SIGTERM, &sa, nullptr);
+  signal(SIGPIPE, SIG_IGN);
+
+  int listenFd = listenOn(path);
+  if (listenFd < 0) return 1;
+
+  int epfd = epoll_create1(EPOLL_CLOEXEC);
+  epoll_event lev{};
+  lev.events = EPOLLIN;
+  lev.data.fd = listenFd;
+  epoll_ctl(epfd, EPOLL_CTL_ADD, listenFd, &lev);
+
+  unordered_map<int, Connection> conns;
+  Engine engine;
+  OutcomeCache cache(cacheSize);
+  if (cacheSize > 0) engine.cache = &cache;
+  engine.alice.setLazyDelete(true); // a deal only removes cards
+  engine.bob.setLazyDelete(true);
+  if (!cachePath.empty()) cache.load(cachePath); // a missing file just starts empty
+  unsigned long long accepted = 0;
+  epoll_event events[MAX_EVENTS];
+
+  while (!stopRequested) {
+    int n = epoll_wait(epfd, events, MAX_EVENTS, -1);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      perror("epoll_wait");
+      break;
+    }
+
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+
+      if (fd == listenFd) {
+        int cfd;
+        while ((cfd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+          Connection& conn = conns[cfd];
+          conn.fd = cfd;
+          conn.events = EPOLLIN;
+          epoll_event ev{};
+          ev.events = conn.events;
+          ev.data.fd = cfd;
+          epoll_ctl(epfd, EPOLL_CTL_ADD, cfd, &ev);
+          ++accepted;
+        }
+        continue;
+      }
+
+      auto found = conns.find(fd);
+      if (found == conns.end()) continue;
+      Connection& conn = found->second;
+
+      bool alive = !(events[i].events & EPOLLERR);
+      if (alive && (events[i].events & (EPOLLIN | EPOLLHUP))) alive = readAndServe(conn, engine);
+      if (alive && (events[i].events & EPOLLOUT)) alive = flush(conn);
+
+      if (alive) {
+        // backpressure: only read more once the peer drains our output;
+        // after a half-close, only wait until the output is delivered
+        size_t pending = pendingOutput(conn);
+        if (conn.peerClosed && pending == 0) alive = false;
+        bool wantRead = !conn.peerClosed && pending <= MAX_PENDING_OUTPUT;
+        uint32_t want = (wantRead ? uint32_t(EPOLLIN) : 0u) | (pending ? uint32_t(EPOLLOUT) : 0u);
+        if (alive) alive = setEvents(epfd, conn, want);
+      }
+      if (!alive) {
+        epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        conns.erase(found);
+      }
+    }
+  }
+
+  for (auto& entry : conns) close(entry.first);
+  close(epfd);
+  close(listenFd);
+  unlink(path);
+
+  cout << "Served " << engine.served << " requests on " << accepted << " connections" << endl;
+  if (engine.cache) {
+    auto st = cache.stats();
+    uint64_t lookups = st.hits + st.misses;
+    cout << "Cache: " << st.hits << " hits, " << st.misses << " misses ("
+         << (lookups ? 100.0 * st.hits / lookups : 0.0) << "% hit rate), "
+         << st.evictions << " evictions, " << st.entries << " entries" << endl;
+    if (!cachePath.empty() && !cache.save(cachePath)) cerr << "Could not write cache " << cachePath << endl;
+  }
+  return 0;
+}
@@ -2,14 +2,21 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
 #include "card.h"
 #include "card_list.h"
+#include "splay_card_list.h"
+#include "outcome_cache.h"
+#include "trace.h"
 #include <algorithm>
 #include <cctype>
 //Do not include set in this file
 
 using namespace std;
 
+// outcomes kept in the --cache file
+constexpr size_t CACHE_CAPACITY = 1 << 16;
+
 // trim helpers (copied from main_set.cpp)
 static inline std::string ltrim_copy(std::string s) {
   s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](unsigned char ch){ return !std::isspace(ch); }));
@@ -47,54 +54,126 @@ Card parseCard(const std::string &s) {
   return Card(suit, rankc);
 }
 
+// read every card in a file (empty lines skipped)
+static vector<Card> loadCards(ifstream &cardFile){
+  trace::Span span("load file");
+  vector<Card> cards;
+  string line;
+  while (getline(cardFile, line)){
+    if(line.empty()) continue;
+    cards.push_back(parseCard(line));
+  }
+  return cards;
+}
+
+// build a hand, inserting each card next to the previous one
+// (O(1) per card when the file is sorted, ascending or descending)
+template <typename Hand>
+static void buildHand(Hand &hand, const vector<Card> &cards){
+  trace::Span span("build tree");
+  typename Hand::iterator hint = hand.end();
+  for(const auto &c : cards) hint = hand.insert(hint, c);
+}
+
+// Print the picks, then the remaining cards in per-line format to match
+// o_*.txt expectations
+template <typename Hand>
+static void printGame(const vector<Card> &moves, const Hand &alice, const Hand &bob){
+  trace::Span span("print");
+  printMoves(moves, cout);
+
+  std::cout << std::endl;
+  std::cout << "Alice's cards:" << std::endl;
+  for (typename Hand::iterator it = alice.begin(); it != alice.end(); ++it) {
+    std::cout << *it << std::endl;
+  }
+  std::cout << std::endl;
+  std::cout << "Bob's cards:" << std::endl;
+  for (typename Hand::iterator it = bob.begin(); it != bob.end(); ++it) {
+    std::cout << *it << std::endl;
+  }
+}
+
 int main(int argv, char** argc){
-  if(argv < 3){
+  // hand files are positional; --cache=<file> memoizes outcomes across runs,
+  // --trace=<file> writes a Chrome trace of the run, --splay plays with
+  // splay-tree hands (see splay_card_list.h)
+  vector<string> files;
+  string cachePath;
+  string tracePath;
+  bool splay = false;
+  for(int i = 1; i < argv; ++i){
+    string arg = argc[i];
+    if(arg.rfind("--cache=", 0) == 0) cachePath = arg.substr(8);
+    else if(arg.rfind("--trace=", 0) == 0) tracePath = arg.substr(8);
+    else if(arg == "--splay") splay = true;
+    else files.push_back(arg);
+  }
+
+  if(files.size() < 2){
     cout << "Please provide 2 file names" << endl;
     return 1;
   }
+  if(splay && !cachePath.empty()){
+    cout << "--cache only works with the default tree" << endl;
+    return 1;
+  }
+  if(!tracePath.empty()) trace::start();
   
-  ifstream cardFile1 (argc[1]);
-  ifstream cardFile2 (argc[2]);
-  string line;
+  ifstream cardFile1 (files[0]);
+  ifstream cardFile2 (files[1]);
 
   if (cardFile1.fail() || cardFile2.fail() ){
-    cout << "Could not open file " << argc[2];
+    cout << "Could not open file " << files[1];
     return 1;
   }
 
   // Read each file into CardList
-  CardList alice;
-  CardList bob;
-
-  while (getline(cardFile1, line)){
-    if(line.empty()) continue;
-    // parse and insert
-    auto c = parseCard(line);
-    alice.insert(c);
-  }
+  vector<Card> aliceCards = loadCards(cardFile1);
   cardFile1.close();
-
-  while (getline(cardFile2, line)){
-    if(line.empty()) continue;
-    auto c = parseCard(line);
-    bob.insert(c);
-  }
+  vector<Card> bobCards = loadCards(cardFile2);
   cardFile2.close();
 
-  // play the game using CardList implementation
-  playGame(alice, bob);
-
-  // Print remaining cards in per-line format to match o_*.txt expectations
-  std::cout << std::endl;
-  std::cout << "Alice's cards:" << std::endl;
-  for (CardList::iterator it = alice.begin(); it != alice.end(); ++it) {
-    std::cout << *it << std::endl;
-  }
-  std::cout << std::endl;
-  std::cout << "Bob's cards:" << std::endl;
-  for (CardList::iterator it = bob.begin(); it != bob.end(); ++it) {
-    std::cout << *it << std::endl;
+  vector<Card> moves;
+  if(splay){
+    SplayCardList alice;
+    SplayCardList bob;
+    buildHand(alice, aliceCards);
+    buildHand(bob, bobCards);
+    {
+      trace::Span span("play");
+      playGame(alice, bob, moves);
+    }
+    printGame(moves, alice, bob);
+  } else {
+    CardList alice;
+    CardList bob;
+    buildHand(alice, aliceCards);
+    buildHand(bob, bobCards);
+
+    // hands only shrink from here on: removals just leave tombstones
+    alice.setLazyDelete(true);
+    bob.setLazyDelete(true);
+
+    // play the game using CardList implementation
+    {
+      trace::Span span("play");
+      if(cachePath.empty()){
+        playGame(alice, bob, moves);
+      } else {
+        OutcomeCache cache(CACHE_CAPACITY);
+        cache.load(cachePath); // a missing cache file just starts empty
+        playCached(&cache, alice, bob, moves);
+        if(!cache.save(cachePath)) cerr << "Could not write cache " << cachePath << endl;
+        auto st = cache.stats();
+        cerr << "cache: " << st.hits << " hits, " << st.misses << " misses, " << st.entries << " entries" << endl;
+      }
+    }
+    printGame(moves, alice, bob);
   }
 
+  if(!tracePath.empty() && !trace::writeJson(tracePath)){
+    cerr << "Could not write trace " << tracePath << endl;
+  }
   return 0;
 }
@@ -4,7 +4,9 @@
 #include <fstream>
 #include <string>
 #include <set>
+#include <vector>
 #include "card.h"
+#include "trace.h"
 #include <algorithm>
 #include <cctype>
 
@@ -28,82 +30,119 @@ static inline std::string trim_copy(std::string s) {
   return ltrim_copy(rtrim_copy(std::move(s)));
 }
 
+// read every card in a file (empty lines skipped)
+static vector<Card> loadCards(ifstream &cardFile){
+  trace::Span span("load file");
+  vector<Card> cards;
+  string line;
+  while (getline(cardFile, line)){
+    if(line.empty()) continue;
+    cards.push_back(parseCard(line));
+  }
+  return cards;
+}
+
 int main(int argv, char** argc){
-  if(argv < 3){
+  // hand files are positional; --trace=<file> writes a Chrome trace of the run
+  vector<string> files;
+  string tracePath;
+  for(int i = 1; i < argv; ++i){
+    string arg = argc[i];
+    if(arg.rfind("--trace=", 0) == 0) tracePath = arg.substr(8);
+    else files.push_back(arg);
+  }
+
+  if(files.size() < 2){
     cout << "Please provide 2 file names" << endl;
     return 1;
   }
+  if(!tracePath.empty()) trace::start();
   
-  ifstream cardFile1 (argc[1]);
-  ifstream cardFile2 (argc[2]);
-  string line;
+  ifstream cardFile1 (files[0]);
+  ifstream cardFile2 (files[1]);
 
   if (cardFile1.fail() || cardFile2.fail() ){
-    cout << "Could not open file " << argc[2];
+    cout << "Could not open file " << files[1];
     return 1;
   }
 
   // Read each file into sets
+  vector<Card> aliceCards = loadCards(cardFile1);
+  cardFile1.close();
+  vector<Card> bobCards = loadCards(cardFile2);
+  cardFile2.close();
+
   set<Card> alice;
   set<Card> bob;
-
-  while (getline(cardFile1, line)){
-    if(line.empty()) continue;
-    alice.insert(parseCard(line));
+  {
+    trace::Span span("build tree");
+    alice.insert(aliceCards.begin(), aliceCards.end());
   }
-  cardFile1.close();
-
-  while (getline(cardFile2, line)){
-    if(line.empty()) continue;
-    bob.insert(parseCard(line));
+  {
+    trace::Span span("build tree");
+    bob.insert(bobCards.begin(), bobCards.end());
   }
-  cardFile2.close();
   
   // Game loop
-  while(true){
-    bool aliceFound = false;
-    // Alice: iterate from smallest to largest
-    for(auto it = alice.begin(); it != alice.end(); ++it){
-      const Card c = *it;
-      auto itb = bob.find(c);
-      if(itb != bob.end()){
-        cout << "Alice picked matching card " << c << endl;
-        // remove from both sets
-        bob.erase(itb);
-        // erase current alice iterator safely
-        alice.erase(it);
-        aliceFound = true;
-        break;
+  {
+    trace::Span span("play");
+    while(true){
+      bool aliceFound = false;
+      {
+        trace::Span span("Alice turn");
+        // Alice: iterate from smallest to largest
+        for(auto it = alice.begin(); it != alice.end(); ++it){
+          const Card c = *it;
+          auto itb = bob.find(c);
+          if(itb != bob.end()){
+            cout << "Alice picked matching card " << c << endl;
+            // remove from both sets
+            bob.erase(itb);
+            // erase current alice iterator safely
+            alice.erase(it);
+            aliceFound = true;
+            break;
+          }
+        }
       }
-    }
-    if(!aliceFound) break;
-
-    bool bobFound = false;
-    // Bob: iterate from largest to smallest
-    for(auto rit = bob.rbegin(); rit != bob.rend(); ++rit){
-      const Card c = *rit;
-      auto ita = alice.find(c);
-      if(ita != alice.end()){
-        cout << "Bob picked matching card " << c << endl;
-        // remove from both sets: erase from alice and bob
-        alice.erase(ita);
-        // erase element pointed by reverse_iterator
-        bob.erase(std::next(rit).base());
-        bobFound = true;
-        break;
+      if(!aliceFound) break;
+
+      bool bobFound = false;
+      {
+        trace::Span span("Bob turn");
+        // Bob: iterate from largest to smallest
+        for(auto rit = bob.rbegin(); rit != bob.rend(); ++rit){
+          const Card c = *rit;
+          auto ita = alice.find(c);
+          if(ita != alice.end()){
+            cout << "Bob picked matching card " << c << endl;
+            // remove from both sets: erase from alice and bob
+            alice.erase(ita);
+            // erase element pointed by reverse_iterator
+            bob.erase(std::next(rit).base());
+            bobFound = true;
+            break;
+          }
+        }
       }
+      if(!bobFound) break;
     }
-    if(!bobFound) break;
   }
 
   // Print remaining cards in per-line format to match o_*.txt expectations
-  cout << endl;
-  cout << "Alice's cards:" << endl;
-  for(const auto &c : alice) cout << c << endl;
-  cout << endl;
-  cout << "Bob's cards:" << endl;
-  for(const auto &c : bob) cout << c << endl;
+  {
+    trace::Span span("print");
+    cout << endl;
+    cout << "Alice's cards:" << endl;
+    for(const auto &c : alice) cout << c << endl;
+    cout << endl;
+    cout << "Bob's cards:" << endl;
+    for(const auto &c : bob) cout << c << endl;
+  }
 
+  if(!tracePath.empty() && !trace::writeJson(tracePath)){
+    cerr << "Could not write trace " << tracePath << endl;
+  }
   return 0;
 }
 
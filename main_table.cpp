@@ -0,0 +1,121 @@
+// This file runs the N-player version of the game (see table.h)
+// Usage: game_table <hand file> <hand file> [more hand files...] [--order=2,0,1]
+// Players sit in file order; even seats pick from the low end of their hand,
+// odd seats from the high end, so two players play exactly like game.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "card.h"
+#include "card_list.h"
+#include "table.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
+using namespace std;
+
+static const char* const PLAYER_NAMES[Table::MAX_PLAYERS] = {
+  "Alice", "Bob", "Carol", "Dave", "Erin", "Frank", "Grace", "Heidi",
+  "Ivan", "Judy", "Mallory", "Niaj", "Olivia", "Peggy", "Rupert", "Sybil"
+};
+
+// trim helpers (copied from main_set.cpp)
+static inline std::string ltrim_copy(std::string s) {
+  s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](unsigned char ch){ return !std::isspace(ch); }));
+  return s;
+}
+
+static inline std::string rtrim_copy(std::string s) {
+  s.erase(std::find_if(s.rbegin(), s.rend(), [](unsigned char ch){ return !std::isspace(ch); }).base(), s.end());
+  return s;
+}
+
+static inline std::string trim_copy(std::string s) {
+  return ltrim_copy(rtrim_copy(std::move(s)));
+}
+
+// parse helper (same normalization as main_set.cpp)
+static Card parseCard(const std::string &s) {
+  std::string t = trim_copy(s);
+  if(t.empty()) return Card();
+
+  char suit = '\0';
+  std::string ranktoken;
+
+  if(t.size() >= 2 && isalpha(t[0])) {
+    suit = tolower(t[0]);
+    ranktoken = t.substr(1);
+    auto pos = ranktoken.find_first_not_of(" \t");
+    if(pos != std::string::npos) ranktoken = ranktoken.substr(pos);
+  }
+
+  char rankc = ' ';
+  if(ranktoken == "10") rankc = 't';
+  else if(!ranktoken.empty()) rankc = tolower(ranktoken[0]);
+
+  return Card(suit, rankc);
+}
+
+int main(int argv, char** argc){
+  vector<string> files;
+  vector<size_t> order;
+  bool badOrder = false;
+  for(int i = 1; i < argv; ++i){
+    string arg = argc[i];
+    if(arg.rfind("--order=", 0) == 0){
+      stringstream ss(arg.substr(8));
+      string seat;
+      while(getline(ss, seat, ',')){
+        size_t index = 0;
+        auto [end, ec] = from_chars(seat.data(), seat.data() + seat.size(), index);
+        badOrder = badOrder || seat.empty() || ec != errc() || end != seat.data() + seat.size();
+        order.push_back(index);
+      }
+    } else {
+      files.push_back(arg);
+    }
+  }
+
+  if(files.size() < 2 || files.size() > Table::MAX_PLAYERS){
+    cout << "Please provide 2 to " << Table::MAX_PLAYERS << " file names" << endl;
+    return 1;
+  }
+
+  Table table;
+  string line;
+  for(size_t seat = 0; seat < files.size(); ++seat){
+    ifstream cardFile (files[seat]);
+    if(cardFile.fail()){
+      cout << "Could not open file " << files[seat];
+      return 1;
+    }
+    CardList hand;
+    CardList::iterator hint = hand.end();
+    while (getline(cardFile, line)){
+      if(line.empty()) continue;
+      hint = hand.insert(hint, parseCard(line));
+    }
+    table.addPlayer(PLAYER_NAMES[seat], hand, seat % 2 == 0 ? Table::Direction::LOWEST : Table::Direction::HIGHEST);
+  }
+
+  if(badOrder || (!order.empty() && !table.setTurnOrder(order))){
+    cout << "Invalid turn order" << endl;
+    return 1;
+  }
+
+  table.play(cout);
+
+  // Print remaining cards in the same per-line format as game
+  for(size_t seat = 0; seat < table.players(); ++seat){
+    cout << endl;
+    cout << table.name(seat) << "'s cards:" << endl;
+    const CardList& hand = table.hand(seat);
+    for (CardList::iterator it = hand.begin(); it != hand.end(); ++it) {
+      cout << *it << endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,18 @@
+// outcome.h
+// Author: Owen Kirchner
+// The result of one game in mask form: the cards played, by index, and
+// the two hands that are left (52-bit masks, see toMask).
+
+#ifndef OUTCOME_H
+#define OUTCOME_H
+
+#include <cstdint>
+
+struct Outcome {
+    std::uint8_t moveCount = 0;
+    std::uint8_t moves[52];     // card indices, Alice's picks at even positions
+    std::uint64_t alice = 0;    // final hands
+    std::uint64_t bob = 0;
+};
+
+#endif
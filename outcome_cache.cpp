@@ -0,0 +1,204 @@
+// outcome_cache.cpp
+// Author: Owen Kirchner
+// Implementation of the classes defined in outcome_cache.h
+
+#include "outcome_cache.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+constexpr char FILE_MAGIC[8] = {'O', 'C', 'A', 'C', 'H', 'E', '1', '\n'};
+
+void writeU64(std::ostream& os, std::uint64_t v) {
+    unsigned char b[8];
+    for (int i = 0; i < 8; ++i) b[i] = static_cast<unsigned char>(v >> (8 * i));
+    os.write(reinterpret_cast<const char*>(b), 8);
+}
+
+bool readU64(std::istream& is, std::uint64_t& v) {
+    unsigned char b[8];
+    if (!is.read(reinterpret_cast<char*>(b), 8)) return false;
+    v = 0;
+    for (int i = 0; i < 8; ++i) v |= std::uint64_t(b[i]) << (8 * i);
+    return true;
+}
+
+} // namespace
+
+// splitmix64 finalizer over both masks
+std::size_t OutcomeCache::KeyHash::operator()(const Key& k) const {
+    std::uint64_t x = k.alice * 0x9e3779b97f4a7c15ULL ^ k.bob;
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return static_cast<std::size_t>(x);
+}
+
+OutcomeCache::OutcomeCache(std::size_t capacity, std::size_t shardCount) {
+    if (shardCount == 0) shardCount = 1;
+    for (std::size_t i = 0; i < shardCount; ++i) {
+        auto shard = std::make_unique<Shard>();
+        // spread capacity evenly; the first shards take the remainder
+        shard->capacity = capacity / shardCount + (i < capacity % shardCount ? 1 : 0);
+        shard->index.reserve(shard->capacity);
+        shards.push_back(std::move(shard));
+    }
+}
+
+OutcomeCache::Shard& OutcomeCache::shardFor(const Key& key) {
+    // top bits pick the shard so they stay independent of the bucket index
+    return *shards[(KeyHash()(key) >> 32) % shards.size()];
+}
+
+bool OutcomeCache::lookup(std::uint64_t alice, std::uint64_t bob, Outcome& out) {
+    Key key{alice, bob};
+    Shard& shard = shardFor(key);
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        auto found = shard.index.find(key);
+        if (found != shard.index.end()) {
+            Slot& slot = shard.slots[found->second];
+            slot.referenced = true;
+            out = slot.outcome;
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void OutcomeCache::store(std::uint64_t alice, std::uint64_t bob, const Outcome& outcome) {
+    Key key{alice, bob};
+    Shard& shard = shardFor(key);
+    if (shard.capacity == 0) return;
+
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto found = shard.index.find(key);
+    if (found != shard.index.end()) {
+        shard.slots[found->second].outcome = outcome;
+        return;
+    }
+
+    if (shard.slots.size() < shard.capacity) {
+        shard.index.emplace(key, shard.slots.size());
+        shard.slots.push_back(Slot{key, outcome, false});
+        return;
+    }
+
+    // CLOCK: give referenced slots a second chance, evict the first one that is not
+    while (shard.slots[shard.hand].referenced) {
+        shard.slots[shard.hand].referenced = false;
+        shard.hand = (shard.hand + 1) % shard.slots.size();
+    }
+    Slot& victim = shard.slots[shard.hand];
+    shard.index.erase(victim.key);
+    victim = Slot{key, outcome, false};
+    shard.index.emplace(key, shard.hand);
+    shard.hand = (shard.hand + 1) % shard.slots.size();
+    evictions.fetch_add(1, std::memory_order_relaxed);
+}
+
+// File layout: magic, entry count, then per entry
+// alice, bob, moveCount, moves[moveCount], final alice, final bob
+bool OutcomeCache::save(const std::string& path) const {
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream os(tmp, std::ios::binary | std::ios::trunc);
+        if (!os) return false;
+        os.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+        std::streampos countPos = os.tellp();
+        writeU64(os, 0); // patched below; shards may change while we write
+        std::uint64_t count = 0;
+        for (const auto& shard : shards) {
+            std::lock_guard<std::mutex> guard(shard->lock);
+            for (const Slot& slot : shard->slots) {
+                writeU64(os, slot.key.alice);
+                writeU64(os, slot.key.bob);
+                os.put(static_cast<char>(slot.outcome.moveCount));
+                os.write(reinterpret_cast<const char*>(slot.outcome.moves), slot.outcome.moveCount);
+                writeU64(os, slot.outcome.alice);
+                writeU64(os, slot.outcome.bob);
+            }
+            count += shard->slots.size();
+        }
+        os.seekp(countPos);
+        writeU64(os, count);
+        if (!os) return false;
+    }
+    // replace atomically so a crash never leaves a truncated cache behind
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+bool OutcomeCache::load(const std::string& path) {
+    std::ifstream is(path, std::ios::binary);
+    if (!is) return false;
+    char magic[sizeof(FILE_MAGIC)];
+    if (!is.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), FILE_MAGIC)) return false;
+
+    // read and check the whole file before storing anything, so a corrupt
+    // or truncated file is rejected as a unit
+    struct Entry {
+        std::uint64_t alice;
+        std::uint64_t bob;
+        Outcome outcome;
+    };
+    std::vector<Entry> entries;
+    std::uint64_t count;
+    if (!readU64(is, count)) return false;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        Entry e;
+        if (!readU64(is, e.alice) || !readU64(is, e.bob)) return false;
+        int n = is.get();
+        if (n < 0 || n > 52) return false;
+        e.outcome.moveCount = static_cast<std::uint8_t>(n);
+        if (!is.read(reinterpret_cast<char*>(e.outcome.moves), n)) return false;
+        if (!readU64(is, e.outcome.alice) || !readU64(is, e.outcome.bob)) return false;
+        // moves are card indices and masks hold 52 bits
+        if (std::any_of(e.outcome.moves, e.outcome.moves + n, [](std::uint8_t m) { return m >= 52; })) return false;
+        if ((e.alice | e.bob | e.outcome.alice | e.outcome.bob) & ~DECK_MASK) return false;
+        entries.push_back(e);
+    }
+    for (const Entry& e : entries) store(e.alice, e.bob, e.outcome);
+    return true;
+}
+
+OutcomeCache::Stats OutcomeCache::stats() const {
+    Stats s{hits.load(), misses.load(), evictions.load(), 0};
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> guard(shard->lock);
+        s.entries += shard->slots.size();
+    }
+    return s;
+}
+
+// Play a deal, answering from the cache when both hands fit in masks
+bool playCached(OutcomeCache* cache, CardList& alice, CardList& bob, std::vector<Card>& moves) {
+    std::uint64_t a, b;
+    if (cache == nullptr || !toMask(alice, a) || !toMask(bob, b)) {
+        playGame(alice, bob, moves);
+        return false;
+    }
+
+    Outcome outcome;
+    if (cache->lookup(a, b, outcome)) {
+        for (std::size_t i = 0; i < outcome.moveCount; ++i) moves.push_back(cardFromIndex(outcome.moves[i]));
+        fromMask(alice, outcome.alice);
+        fromMask(bob, outcome.bob);
+        return true;
+    }
+
+    std::size_t first = moves.size();
+    playGame(alice, bob, moves);
+    outcome.moveCount = static_cast<std::uint8_t>(moves.size() - first);
+    for (std::size_t i = 0; i < outcome.moveCount; ++i) outcome.moves[i] = static_cast<std::uint8_t>(cardIndex(moves[first + i]));
+    toMask(alice, outcome.alice);
+    toMask(bob, outcome.bob);
+    cache->store(a, b, outcome);
+    return false;
+}
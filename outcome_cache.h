@@ -0,0 +1,84 @@
+// outcome_cache.h
+// Author: Owen Kirchner
+// Memoized game outcomes keyed on the (Alice, Bob) pair of 52-bit hand masks.
+// playGame is deterministic in both hands, so a repeated deal can be answered
+// from the cache instead of being replayed.
+//
+// The table is bounded and split into independently locked shards; each
+// shard evicts with the CLOCK (second chance) policy. The contents can be
+// saved to and loaded from a file so hits carry across runs.
+
+#ifndef OUTCOME_CACHE_H
+#define OUTCOME_CACHE_H
+
+#include "card.h"
+#include "card_list.h"
+#include "outcome.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class OutcomeCache {
+public:
+    struct Stats {
+        std::uint64_t hits;
+        std::uint64_t misses;
+        std::uint64_t evictions;
+        std::size_t entries;
+    };
+
+    // capacity is the total number of outcomes kept across all shards
+    explicit OutcomeCache(std::size_t capacity, std::size_t shardCount = 16);
+
+    // Copies the cached outcome for the deal into out; false on a miss
+    bool lookup(std::uint64_t alice, std::uint64_t bob, Outcome& out);
+    void store(std::uint64_t alice, std::uint64_t bob, const Outcome& outcome);
+
+    // Persistence; load merges into the current contents (up to capacity)
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    Stats stats() const;
+
+private:
+    struct Key {
+        std::uint64_t alice;
+        std::uint64_t bob;
+        bool operator==(const Key& other) const { return alice == other.alice && bob == other.bob; }
+    };
+    struct KeyHash {
+        std::size_t operator()(const Key& k) const;
+    };
+    struct Slot {
+        Key key;
+        Outcome outcome;
+        bool referenced;
+    };
+    struct Shard {
+        mutable std::mutex lock;
+        std::vector<Slot> slots;   // grows up to capacity, then slots are recycled
+        std::unordered_map<Key, std::size_t, KeyHash> index;
+        std::size_t capacity = 0;
+        std::size_t hand = 0;      // CLOCK hand
+    };
+
+    Shard& shardFor(const Key& key);
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+    std::atomic<std::uint64_t> evictions{0};
+};
+
+// Play alice vs bob like playGame(alice, bob, moves), consulting cache first.
+// Hands holding cards outside the 52-card deck (or a null cache) are always
+// played. Returns true on a cache hit.
+bool playCached(OutcomeCache* cache, CardList& alice, CardList& bob, std::vector<Card>& moves);
+
+#endif
@@ -0,0 +1,49 @@
+// play_game.h
+// Author: Owen Kirchner
+// The game loop shared by every hand container with CardList's iterator API
+// (begin/end/rbegin/rend, find, erase(iterator)).
+
+#ifndef PLAY_GAME_H
+#define PLAY_GAME_H
+
+#include "card.h"
+#include "trace.h"
+#include <vector>
+
+// Appends every picked card to moves (Alice's picks at even positions,
+// Bob's at odd positions)
+template <typename Hand>
+void playHands(Hand &alice, Hand &bob, std::vector<Card> &moves) {
+    // Neither hand ever gains a card, so a card that had no match once never
+    // gets one later: Alice's scan resumes after her last pick and Bob's
+    // below his, and each pick costs one search of the opponent's hand.
+    typename Hand::iterator a = alice.begin();
+    typename Hand::iterator b = bob.rbegin();
+    while (true) {
+        {
+            trace::Span span("Alice turn");
+            // Alice: smallest -> largest
+            typename Hand::iterator match = bob.end();
+            while (a != alice.end() && (match = bob.find(*a)) == bob.end()) ++a;
+            if (a == alice.end()) break;
+            moves.push_back(*a);
+            if (match == b) --b; // Bob has not scanned past this card yet
+            bob.erase(match);
+            a = alice.erase(a);
+        }
+        {
+            trace::Span span("Bob turn");
+            // Bob: largest -> smallest (use rbegin()/rend() and operator--)
+            typename Hand::iterator match = alice.end();
+            while (b != bob.rend() && (match = alice.find(*b)) == alice.end()) --b;
+            if (b == bob.rend()) break;
+            moves.push_back(*b);
+            if (match == a) a = alice.erase(a);
+            else alice.erase(match);
+            typename Hand::iterator pick = b--;
+            bob.erase(pick);
+        }
+    }
+}
+
+#endif
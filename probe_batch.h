@@ -0,0 +1,62 @@
+// probe_batch.h
+// Author: Owen Kirchner
+// Interleaved binary-search-tree lookups for batches of keys.
+// A single lookup is a chain of dependent loads: the next node's address is
+// only known once the current node has arrived from memory. Running GROUP
+// lookups side by side as small state machines hides most of that latency.
+// Each step of one lookup prefetches the node it will visit next and then
+// moves on to the other lookups, so by the time it comes back around, that
+// node is (ideally) already in cache. It only pays off once the tree no
+// longer fits in cache; on a cache-resident tree the extra bookkeeping
+// makes it slower than plain lookups. A CardList never gets there (the
+// card order allows about 70 distinct nodes), so nothing in the game uses
+// this; bench.cpp measures it on a large tree with CardList's node layout.
+
+#ifndef PROBE_BATCH_H
+#define PROBE_BATCH_H
+
+#include <cstddef>
+
+// Looks up keys[0..n) in the tree under root, writing found[i] for keys[i].
+// visit(node, key, found) examines one node: it returns the child to
+// continue with, or nullptr once the lookup is over, having set found.
+template <std::size_t GROUP, typename Node, typename Key, typename Visit>
+void probeInterleaved(const Node* root, const Key* keys, std::size_t n, bool* found, Visit visit) {
+    if (root == nullptr) {
+        for (std::size_t i = 0; i < n; ++i) found[i] = false;
+        return;
+    }
+
+    struct Probe {
+        const Node* node;   // next node to visit
+        std::size_t index;  // key being looked up; n once the slot is idle
+    };
+    Probe probes[GROUP];
+    std::size_t next = 0;
+    std::size_t active = 0;
+    for (Probe& p : probes) {
+        p.node = root;
+        p.index = next < n ? next++ : n;
+        active += p.index != n;
+    }
+
+    while (active > 0) {
+        for (Probe& p : probes) {
+            if (p.index == n) continue;
+            const Node* child = visit(p.node, keys[p.index], found[p.index]);
+            if (child != nullptr) {
+                __builtin_prefetch(child);
+                p.node = child;
+            } else if (next < n) {
+                // this lookup is done: start the next key in its slot
+                p.node = root;
+                p.index = next++;
+            } else {
+                p.index = n;
+                --active;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,322 @@
+// splay_card_list.cpp
+// Author: Owen Kirchner
+// Implementation of the classes defined in splay_card_list.h
+
+#include "splay_card_list.h"
+#include "card_list.h"
+#include "play_game.h"
+#include <iostream>
+
+// Node Constructor
+SplayCardList::Node::Node(const Card& c) : card(c), left(nullptr), right(nullptr), parent(nullptr) {
+}
+
+SplayCardList::SplayCardList() : root(nullptr), count(0) {
+}
+
+SplayCardList::SplayCardList(const SplayCardList& other)
+    : root(copy_helper(other.root, nullptr)), count(other.count) {
+}
+
+SplayCardList& SplayCardList::operator=(const SplayCardList& other) {
+    if (this != &other) {
+        delete_helper(root);
+        root = copy_helper(other.root, nullptr);
+        count = other.count;
+    }
+    return *this;
+}
+
+SplayCardList::SplayCardList(SplayCardList&& other) noexcept : root(other.root), count(other.count) {
+    other.root = nullptr;
+    other.count = 0;
+}
+
+SplayCardList& SplayCardList::operator=(SplayCardList&& other) noexcept {
+    if (this != &other) {
+        delete_helper(root);
+        root = other.root;
+        count = other.count;
+        other.root = nullptr;
+        other.count = 0;
+    }
+    return *this;
+}
+
+SplayCardList::~SplayCardList() {
+    delete_helper(root);
+}
+
+void SplayCardList::clear() {
+    delete_helper(root);
+    root = nullptr;
+    count = 0;
+}
+
+void SplayCardList::delete_helper(Node* node) {
+    if (node == nullptr) return;
+    delete_helper(node->left);
+    delete_helper(node->right);
+    delete node;
+}
+
+SplayCardList::Node* SplayCardList::copy_helper(Node* node, Node* parent) const {
+    if (node == nullptr) return nullptr;
+    Node* n = new Node(node->card);
+    n->parent = parent;
+    n->left = copy_helper(node->left, n);
+    n->right = copy_helper(node->right, n);
+    return n;
+}
+
+// restructuring
+
+// Helper: single rotation lifting n above its parent
+void SplayCardList::rotate(Node* n) const {
+    Node* p = n->parent;
+    Node* g = p->parent;
+    if (p->left == n) {
+        p->left = n->right;
+        if (n->right) n->right->parent = p;
+        n->right = p;
+    } else {
+        p->right = n->left;
+        if (n->left) n->left->parent = p;
+        n->left = p;
+    }
+    p->parent = n;
+    n->parent = g;
+    if (g == nullptr) root = n;
+    else if (g->left == p) g->left = n;
+    else g->right = n;
+}
+
+// Helper: bottom-up splay (zig, zig-zig, zig-zag) until n is the root
+void SplayCardList::splay(Node* n) const {
+    while (n->parent) {
+        Node* p = n->parent;
+        Node* g = p->parent;
+        if (g == nullptr) {
+            rotate(n);
+        } else if ((g->left == p) == (p->left == n)) {
+            rotate(p); // zig-zig: the parent goes first, halving the path
+            rotate(n);
+        } else {
+            rotate(n);
+            rotate(n);
+        }
+    }
+}
+
+// Helper: node holding card, or nullptr; whichever node the search ended
+// on is splayed so a miss still brings its neighbourhood up
+SplayCardList::Node* SplayCardList::find_node(const Card& card) const {
+    Node* last = nullptr;
+    Node* cur = root;
+    while (cur && !(card == cur->card)) {
+        last = cur;
+        cur = (card < cur->card) ? cur->left : cur->right;
+    }
+    if (cur) splay(cur);
+    else if (last) splay(last);
+    return cur;
+}
+
+// Helper: link a new leaf under parent (or as the root) and splay it up
+SplayCardList::Node* SplayCardList::attach(Node* parent, bool asLeft, const Card& card) {
+    Node* n = new Node(card);
+    n->parent = parent;
+    if (parent == nullptr) root = n;
+    else if (asLeft) parent->left = n;
+    else parent->right = n;
+    ++count;
+    splay(n);
+    return n;
+}
+
+SplayCardList::Node* SplayCardList::insert_node(const Card& card) {
+    Node* parent = nullptr;
+    Node* cur = root;
+    while (cur) {
+        parent = cur;
+        if (card < cur->card) {
+            cur = cur->left;
+        } else if (card > cur->card) {
+            cur = cur->right;
+        } else {
+            splay(cur); // already held
+            return cur;
+        }
+    }
+    return attach(parent, parent && card < parent->card, card);
+}
+
+// Helper: splay node to the root, then join its subtrees under the largest
+// card of the left one
+void SplayCardList::erase_node(Node* node) {
+    splay(node);
+    Node* left = node->left;
+    Node* right = node->right;
+    if (left == nullptr) {
+        root = right;
+        if (right) right->parent = nullptr;
+    } else {
+        left->parent = nullptr;
+        root = left;
+        Node* m = maximumNode(left);
+        splay(m); // m has no right child now
+        m->right = right;
+        if (right) right->parent = m;
+    }
+    delete node;
+    --count;
+}
+
+// public operations
+
+void SplayCardList::insert(const Card& card) {
+    insert_node(card);
+}
+
+void SplayCardList::remove(const Card& card) {
+    Node* n = find_node(card);
+    if (n != nullptr) erase_node(n);
+}
+
+bool SplayCardList::contains(const Card& card) const {
+    return find_node(card) != nullptr;
+}
+
+bool SplayCardList::search(const Card& card) const {
+    return contains(card);
+}
+
+std::size_t SplayCardList::size() const {
+    return count;
+}
+
+void SplayCardList::print(std::ostream& os) const {
+    print_helper(root, os);
+}
+
+void SplayCardList::print_helper(Node* node, std::ostream& os) const {
+    if (node == nullptr) return;
+    print_helper(node->left, os);
+    os << ' ' << node->card;
+    print_helper(node->right, os);
+}
+
+// iterator implementation
+
+SplayCardList::Node* SplayCardList::minimumNode(Node* n) {
+    if (!n) return nullptr;
+    while (n->left) n = n->left;
+    return n;
+}
+SplayCardList::Node* SplayCardList::maximumNode(Node* n) {
+    if (!n) return nullptr;
+    while (n->right) n = n->right;
+    return n;
+}
+
+SplayCardList::Node* SplayCardList::nextNode(Node* n) {
+    if (n == nullptr) return nullptr;
+    if (n->right) return minimumNode(n->right);
+    while (n->parent && n->parent->right == n) n = n->parent;
+    return n->parent;
+}
+
+SplayCardList::Node* SplayCardList::prevNode(Node* n) {
+    if (n == nullptr) return nullptr;
+    if (n->left) return maximumNode(n->left);
+    while (n->parent && n->parent->left == n) n = n->parent;
+    return n->parent;
+}
+
+SplayCardList::iterator::iterator() : node(nullptr), tree(nullptr) {}
+SplayCardList::iterator::iterator(Node* n, const SplayCardList* t) : node(n), tree(t) {}
+
+SplayCardList::iterator::reference SplayCardList::iterator::operator*() const {
+    return node->card;
+}
+SplayCardList::iterator::pointer SplayCardList::iterator::operator->() const {
+    return &(node->card);
+}
+
+// stepping does not splay: a scan is already O(1) amortized per step
+SplayCardList::iterator& SplayCardList::iterator::operator++() {
+    node = nextNode(node);
+    return *this;
+}
+SplayCardList::iterator SplayCardList::iterator::operator++(int) {
+    iterator tmp = *this;
+    ++(*this);
+    return tmp;
+}
+
+SplayCardList::iterator& SplayCardList::iterator::operator--() {
+    node = (node == nullptr) ? maximumNode(tree->root) : prevNode(node);
+    return *this;
+}
+SplayCardList::iterator SplayCardList::iterator::operator--(int) {
+    iterator tmp = *this;
+    --(*this);
+    return tmp;
+}
+
+bool SplayCardList::iterator::operator==(const iterator& other) const {
+    return node == other.node;
+}
+bool SplayCardList::iterator::operator!=(const iterator& other) const {
+    return !(*this == other);
+}
+
+SplayCardList::iterator SplayCardList::begin() const { return iterator(minimumNode(root), this); }
+SplayCardList::iterator SplayCardList::end() const { return iterator(nullptr, this); }
+SplayCardList::iterator SplayCardList::rbegin() const { return iterator(maximumNode(root), this); }
+SplayCardList::iterator SplayCardList::rend() const { return iterator(nullptr, this); }
+
+// iterator-based access
+
+SplayCardList::iterator SplayCardList::find(const Card& card) const {
+    return iterator(find_node(card), this);
+}
+
+SplayCardList::iterator SplayCardList::insert(iterator hint, const Card& card) {
+    Node* h = hint.node;
+    if (h == nullptr) {
+        Node* last = maximumNode(root); // the root after an append
+        if (last == nullptr || card > last->card) return iterator(attach(last, false, card), this);
+    } else if (card > h->card) {
+        Node* next = nextNode(h);
+        if (next == nullptr || card < next->card) {
+            return iterator(h->right == nullptr ? attach(h, false, card) : attach(next, true, card), this);
+        }
+    } else if (card < h->card) {
+        Node* prev = prevNode(h);
+        if (prev == nullptr || card > prev->card) {
+            return iterator(h->left == nullptr ? attach(h, true, card) : attach(prev, false, card), this);
+        }
+    } else {
+        return hint; // already held
+    }
+    return iterator(insert_node(card), this);
+}
+
+SplayCardList::iterator SplayCardList::erase(iterator pos) {
+    iterator next = pos;
+    ++next;
+    erase_node(pos.node);
+    return next;
+}
+
+// playGame: the CardList game loop over splay trees
+void playGame(SplayCardList &alice, SplayCardList &bob, std::vector<Card> &moves) {
+    playHands(alice, bob, moves);
+}
+
+void playGame(SplayCardList &alice, SplayCardList &bob) {
+    std::vector<Card> moves;
+    playHands(alice, bob, moves);
+    printMoves(moves, std::cout);
+}
@@ -0,0 +1,114 @@
+// splay_card_list.h
+// Author: Owen Kirchner
+// Self-adjusting (splay tree) version of CardList with the same hand API.
+// Every insert, find and contains rotates the card it reached to the root,
+// so cards that were just touched, and their neighbours, are found again in
+// a few steps. playGame keeps probing the two ends of each hand, which a
+// plain BST pays full depth for on every turn. Sequences of operations cost
+// O(log n) amortized; a single one can take O(n).
+//
+// Splaying only rotates nodes, it never copies or frees them, so iterators
+// stay valid across lookups (erase invalidates only the erased card).
+
+#ifndef SPLAY_CARD_LIST_H
+#define SPLAY_CARD_LIST_H
+
+#include "card.h"
+#include <cstddef>
+#include <iosfwd>
+#include <iterator>
+#include <vector>
+
+class SplayCardList {
+private:
+    struct Node {
+        Card card;
+        Node* left;
+        Node* right;
+        Node* parent;
+
+        Node(const Card& c);
+    };
+
+    // lookups are logically const but restructure the tree
+    mutable Node* root;
+    std::size_t count;
+
+    void rotate(Node* n) const;                   // lift n above its parent
+    void splay(Node* n) const;                    // rotate n up to the root
+    Node* find_node(const Card& card) const;      // splays the last node reached
+    Node* attach(Node* parent, bool asLeft, const Card& card);
+    Node* insert_node(const Card& card);          // node holding card after insert
+    void erase_node(Node* node);
+    void print_helper(Node* node, std::ostream& os) const;
+    void delete_helper(Node* node);
+    Node* copy_helper(Node* node, Node* parent) const;
+
+    static Node* minimumNode(Node* n);
+    static Node* maximumNode(Node* n);
+    static Node* nextNode(Node* n);
+    static Node* prevNode(Node* n);
+
+public:
+    SplayCardList();
+    SplayCardList(const SplayCardList& other);
+    SplayCardList& operator=(const SplayCardList& other);
+    SplayCardList(SplayCardList&& other) noexcept;
+    SplayCardList& operator=(SplayCardList&& other) noexcept;
+    ~SplayCardList();
+
+    void insert(const Card& card);
+    void remove(const Card& card);
+    void clear();
+
+    bool contains(const Card& card) const;
+    bool search(const Card& card) const;
+    std::size_t size() const;
+
+    void print(std::ostream& os) const;
+
+    // Bidirectional iterator (same semantics as CardList::iterator)
+    class iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Card;
+        using reference = const Card&;
+        using pointer = const Card*;
+
+        iterator();
+        reference operator*() const;
+        pointer operator->() const;
+
+        iterator& operator++();
+        iterator operator++(int);
+        iterator& operator--();
+        iterator operator--(int);
+
+        bool operator==(const iterator& other) const;
+        bool operator!=(const iterator& other) const;
+
+    private:
+        friend class SplayCardList;
+        iterator(Node* n, const SplayCardList* tree);
+        Node* node;
+        const SplayCardList* tree; // needed to step back from end()
+    };
+
+    iterator begin() const;
+    iterator end() const;
+    iterator rbegin() const; // returns iterator to largest
+    iterator rend() const;   // past-the-begin (nullptr)
+
+    iterator find(const Card& card) const;       // end() if not held
+    // Insert next to hint (a neighbour on either side, or end() to append);
+    // a right hint skips the search. Returns an iterator to the card.
+    iterator insert(iterator hint, const Card& card);
+    // Remove the card at pos; returns an iterator to the next larger card
+    iterator erase(iterator pos);
+};
+
+// Same game and move recording as the CardList overloads
+void playGame(SplayCardList &alice, SplayCardList &bob);
+void playGame(SplayCardList &alice, SplayCardList &bob, std::vector<Card> &moves);
+
+#endif
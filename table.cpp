@@ -0,0 +1,106 @@
+// table.cpp
+// Author: Owen Kirchner
+// Implementation of the classes defined in table.h
+
+#include "table.h"
+#include <ostream>
+
+bool Table::addPlayer(const std::string& name, const CardList& hand, Direction dir) {
+    if (seats.size() == MAX_PLAYERS) return false;
+    seats.push_back(Player{name, hand, CardList(), dir});
+    seats.back().hand.rebalance();
+    seats.back().hand.setLazyDelete(true); // hands only shrink during play
+    return true;
+}
+
+bool Table::setTurnOrder(const std::vector<std::size_t>& order) {
+    std::uint32_t seen = 0;
+    for (std::size_t seat : order) {
+        if (seat >= seats.size() || (seen & (1u << seat))) return false;
+        seen |= 1u << seat;
+    }
+    turnOrder = order;
+    return true;
+}
+
+std::size_t Table::players() const { return seats.size(); }
+const std::string& Table::name(std::size_t seat) const { return seats[seat].name; }
+const CardList& Table::hand(std::size_t seat) const { return seats[seat].hand; }
+
+// Build the card -> holders index and each player's contested set
+void Table::buildIndex() {
+    holders.clear();
+    for (std::size_t s = 0; s < seats.size(); ++s) {
+        for (CardList::iterator it = seats[s].hand.begin(); it != seats[s].hand.end(); ++it) {
+            holders[*it] |= static_cast<std::uint16_t>(1u << s);
+        }
+    }
+
+    // shared = cards held by two or more seats, in linear passes
+    CardList seen, shared;
+    for (const Player& p : seats) {
+        shared.set_union_with(seen.set_intersection(p.hand));
+        seen.set_union_with(p.hand);
+    }
+    for (Player& p : seats) {
+        p.contested = p.hand.set_intersection(shared);
+        p.contested.setLazyDelete(true);
+    }
+}
+
+void Table::removeCard(std::size_t seat, const Card& card) {
+    seats[seat].hand.remove(card);
+    seats[seat].contested.remove(card);
+
+    auto entry = holders.find(card);
+    std::uint16_t left = entry->second & static_cast<std::uint16_t>(~(1u << seat));
+    if (left == 0) {
+        holders.erase(entry);
+        return;
+    }
+    entry->second = left;
+    // a single remaining holder no longer shares the card with anyone
+    if ((left & (left - 1)) == 0) seats[__builtin_ctz(left)].contested.remove(card);
+}
+
+std::size_t Table::nextHolder(std::size_t seat, const Card& card) const {
+    std::uint16_t mask = holders.at(card);
+    for (std::size_t k = 1; k < seats.size(); ++k) {
+        std::size_t s = (seat + k) % seats.size();
+        if (mask & (1u << s)) return s;
+    }
+    return seat;
+}
+
+void Table::play(std::vector<Pick>& picks) {
+    if (turnOrder.empty()) {
+        for (std::size_t s = 0; s < seats.size(); ++s) turnOrder.push_back(s);
+    }
+    buildIndex();
+
+    // stop once every seat in the order has passed in a row
+    std::size_t passes = 0;
+    for (std::size_t turn = 0; passes < turnOrder.size(); ++turn) {
+        std::size_t seat = turnOrder[turn % turnOrder.size()];
+        const CardList& contested = seats[seat].contested;
+        if (contested.size() == 0) {
+            ++passes;
+            continue;
+        }
+        passes = 0;
+
+        Card card = seats[seat].dir == Direction::LOWEST ? *contested.begin() : *contested.rbegin();
+        std::size_t from = nextHolder(seat, card);
+        removeCard(seat, card);
+        removeCard(from, card);
+        picks.push_back(Pick{seat, from, card});
+    }
+}
+
+void Table::play(std::ostream& os) {
+    std::vector<Pick> picks;
+    play(picks);
+    for (const Pick& p : picks) {
+        os << seats[p.picker].name << " picked matching card " << p.card << std::endl;
+    }
+}
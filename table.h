@@ -0,0 +1,74 @@
+// table.h
+// Author: Owen Kirchner
+// N-player version of the game: 2 to 16 players take turns in a configurable
+// order, and on each turn the player picks a card they hold that some
+// opponent also holds, scanning their hand from the low or the high end.
+// Both copies of the card leave play. The game ends once a full round of
+// turns passes without a pick.
+//
+// An inverted index maps each card to the set of seats holding it, and every
+// player keeps the subset of their hand that is contested (held by someone
+// else too), so a turn is a lookup at one end of that subset instead of a
+// scan of every opponent's hand.
+
+#ifndef TABLE_H
+#define TABLE_H
+
+#include "card.h"
+#include "card_list.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+class Table {
+public:
+    static constexpr std::size_t MAX_PLAYERS = 16;
+
+    // which end of the hand a player picks from
+    enum class Direction { LOWEST, HIGHEST };
+
+    struct Pick {
+        std::size_t picker;   // seat that made the pick
+        std::size_t from;     // opponent seat that also gave up the card
+        Card card;
+    };
+
+    // Seats a player (seat numbers follow the order of calls); false if full
+    bool addPlayer(const std::string& name, const CardList& hand, Direction dir);
+
+    // Seats take turns in this order, repeating; default is seating order.
+    // False (and no change) on an unknown or repeated seat.
+    bool setTurnOrder(const std::vector<std::size_t>& order);
+
+    // Play to completion, recording each pick or printing it as
+    // "<name> picked matching card <card>"
+    void play(std::vector<Pick>& picks);
+    void play(std::ostream& os);
+
+    std::size_t players() const;
+    const std::string& name(std::size_t seat) const;
+    const CardList& hand(std::size_t seat) const;
+
+private:
+    struct Player {
+        std::string name;
+        CardList hand;
+        CardList contested;   // cards in hand also held by another seat
+        Direction dir;
+    };
+
+    std::vector<Player> seats;
+    std::vector<std::size_t> turnOrder;
+    std::map<Card, std::uint16_t> holders;   // inverted index: card -> bitmask of seats
+
+    void buildIndex();
+    // Take card out of seat's hand, keeping the index and contested sets in sync
+    void removeCard(std::size_t seat, const Card& card);
+    // Next seat after seat (cyclically) that holds card
+    std::size_t nextHolder(std::size_t seat, const Card& card) const;
+};
+
+#endif
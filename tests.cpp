@@ -1,11 +1,23 @@
 #include "card_list.h"
 #include "card.h"
+#include "outcome_cache.h"
+#include "table.h"
+#include "trace.h"
+#include "disk_card_list.h"
+#include "splay_card_list.h"
+#include "deal_kernel.h"
+#include "probe_batch.h"
 
 #include <iostream>
 #include <sstream>
 #include <vector>
 #include <cassert>
 #include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <memory>
 
 using namespace std;
 
@@ -221,6 +233,586 @@ int main() {
     }
     cout << "playGame tests passed." << endl;
 
+    // ===== 7) Card indices, hand masks and recorded moves =====
+    {
+        assert(cardIndex(Card('c','a')) == 0);
+        assert(cardIndex(Card('h','k')) == 51);
+        assert(cardIndex(Card('x','a')) == -1);
+        for (int i = 0; i < 52; ++i) {
+            assert(cardIndex(cardFromIndex(i)) == i);
+            if (i > 0) assert(cardFromIndex(i - 1) < cardFromIndex(i));
+        }
+
+        CardList hand;
+        uint64_t mask = (uint64_t(1) << 0) | (uint64_t(1) << 17) | (uint64_t(1) << 51);
+        fromMask(hand, mask);
+        vector<Card> expected = { cardFromIndex(0), cardFromIndex(17), cardFromIndex(51) };
+        assert(seq_inorder(hand) == expected);
+        uint64_t back = 0;
+        assert(toMask(hand, back) && back == mask);
+        hand.insert(Card('x','a'));
+        assert(!toMask(hand, back));
+        hand.clear();
+        assert(hand.begin() == hand.end());
+
+        // Alice picks low, Bob picks high, alternating
+        CardList alice, bob;
+        for (char r : {'2', '3', '4'}) { alice.insert(Card('c', r)); bob.insert(Card('c', r)); }
+        vector<Card> moves;
+        playGame(alice, bob, moves);
+        expected = { Card('c','2'), Card('c','4'), Card('c','3') };
+        assert(moves == expected);
+        assert(alice.begin() == alice.end() && bob.begin() == bob.end());
+    }
+    cout << "Mask/move-recording tests passed." << endl;
+
+    // ===== 8) Outcome cache: hits, CLOCK eviction, persistence =====
+    {
+        OutcomeCache cache(2, 1); // one shard so eviction order is predictable
+        CardList alice, bob, alice2, bob2;
+        for (char r : {'2', '3', '4'}) { alice.insert(Card('d', r)); bob.insert(Card('d', r)); }
+        alice.insert(Card('h','k'));
+        alice2 = alice;
+        bob2 = bob;
+
+        vector<Card> played, cached;
+        assert(!playCached(&cache, alice, bob, played));
+        assert(playCached(&cache, alice2, bob2, cached));
+        assert(played == cached);
+        assert(seq_inorder(alice) == seq_inorder(alice2));
+        assert(seq_inorder(bob) == seq_inorder(bob2));
+
+        Outcome o;
+        cache.store(1, 2, o);              // fills the second slot
+        assert(cache.lookup(1, 2, o));     // referenced: survives the next eviction
+        cache.store(3, 4, o);              // evicts the unreferenced deal played above
+        assert(cache.lookup(1, 2, o) && cache.lookup(3, 4, o));
+        OutcomeCache::Stats st = cache.stats();
+        assert(st.entries == 2 && st.evictions == 1);
+
+        const char* path = "test_outcome_cache.bin";
+        assert(cache.save(path));
+        OutcomeCache reloaded(16);
+        assert(reloaded.load(path));
+        assert(reloaded.lookup(1, 2, o) && reloaded.lookup(3, 4, o));
+        assert(reloaded.stats().entries == 2);
+
+        // corrupt files are rejected whole: nothing from them is stored
+        Outcome badMove;
+        badMove.moveCount = 1;
+        badMove.moves[0] = 60;              // not a card index
+        OutcomeCache corrupt(4, 1);
+        corrupt.store(5, 6, o);
+        corrupt.store(7, 8, badMove);
+        assert(corrupt.save(path));
+        OutcomeCache fresh(16);
+        assert(!fresh.load(path) && fresh.stats().entries == 0);
+
+        OutcomeCache wideMask(4, 1);
+        wideMask.store(uint64_t(1) << 60, 1, o); // bit past the deck
+        assert(wideMask.save(path));
+        assert(!fresh.load(path) && fresh.stats().entries == 0);
+
+        assert(cache.save(path));
+        {
+            std::ifstream in(path, std::ios::binary);
+            string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out << bytes.substr(0, bytes.size() - 3); // truncated last entry
+        }
+        assert(!fresh.load(path) && fresh.stats().entries == 0);
+        std::remove(path);
+
+        // hands outside the 52-card deck bypass the cache
+        CardList odd;
+        odd.insert(Card('x','a'));
+        CardList other;
+        vector<Card> none;
+        assert(!playCached(&cache, odd, other, none));
+    }
+    cout << "Outcome cache tests passed." << endl;
+
+    // ===== 9) Set algebra (new lists and in-place variants) =====
+    {
+        CardList a, b;
+        for (int i : {0, 3, 5, 7, 9, 20}) a.insert(cardFromIndex(i));
+        for (int i : {3, 4, 9, 30, 51}) b.insert(cardFromIndex(i));
+        auto cards = [](std::initializer_list<int> idx) {
+            vector<Card> v;
+            for (int i : idx) v.push_back(cardFromIndex(i));
+            return v;
+        };
+
+        assert(seq_inorder(a.set_union(b)) == cards({0, 3, 4, 5, 7, 9, 20, 30, 51}));
+        assert(seq_inorder(a.set_intersection(b)) == cards({3, 9}));
+        assert(seq_inorder(a.set_difference(b)) == cards({0, 5, 7, 20}));
+        assert(seq_inorder(a.set_symmetric_difference(b)) == cards({0, 4, 5, 7, 20, 30, 51}));
+        assert(a.set_union(b).size() == 9 && a.size() == 6 && b.size() == 5);
+        assert(seq_reverse(a.set_union(b)) == cards({51, 30, 20, 9, 7, 5, 4, 3, 0}));
+
+        CardList u = a, x = a, d = a, sd = a;
+        u.set_union_with(b);
+        x.set_intersection_with(b);
+        d.set_difference_with(b);
+        sd.set_symmetric_difference_with(b);
+        assert(seq_inorder(u) == seq_inorder(a.set_union(b)));
+        assert(seq_inorder(x) == cards({3, 9}) && x.size() == 2);
+        assert(seq_inorder(d) == cards({0, 5, 7, 20}));
+        assert(seq_inorder(sd) == seq_inorder(a.set_symmetric_difference(b)));
+
+        // results stay usable as ordinary lists
+        u.remove(cardFromIndex(9));
+        u.insert(cardFromIndex(10));
+        assert(!u.contains(cardFromIndex(9)) && u.contains(cardFromIndex(10)) && u.size() == 9);
+
+        // aliasing and empty operands
+        CardList self = a;
+        self.set_difference_with(self);
+        assert(self.size() == 0 && self.begin() == self.end());
+        CardList empty;
+        assert(seq_inorder(a.set_union(empty)) == seq_inorder(a));
+        assert(empty.set_intersection(a).size() == 0);
+    }
+    cout << "Set algebra tests passed." << endl;
+
+    // ===== 10) N-player table =====
+    {
+        // two players match playGame pick for pick
+        CardList alice, bob;
+        for (int i : {1, 4, 9, 12, 20, 33, 40, 51}) alice.insert(cardFromIndex(i));
+        for (int i : {0, 4, 12, 13, 20, 33, 51}) bob.insert(cardFromIndex(i));
+        Table duel;
+        assert(duel.addPlayer("Alice", alice, Table::Direction::LOWEST));
+        assert(duel.addPlayer("Bob", bob, Table::Direction::HIGHEST));
+        std::ostringstream tableOut, gameOut;
+        duel.play(tableOut);
+        vector<Card> moves;
+        playGame(alice, bob, moves);
+        printMoves(moves, gameOut);
+        assert(tableOut.str() == gameOut.str());
+        assert(seq_inorder(duel.hand(0)) == seq_inorder(alice));
+        assert(seq_inorder(duel.hand(1)) == seq_inorder(bob));
+
+        // three players: c2 is held by all three, c3 by seats 1 and 2
+        CardList h0, h1, h2;
+        h0.insert(Card('c','2'));
+        h0.insert(Card('h','k'));
+        h1.insert(Card('c','2'));
+        h1.insert(Card('c','3'));
+        h2.insert(Card('c','2'));
+        h2.insert(Card('c','3'));
+        Table table;
+        table.addPlayer("A", h0, Table::Direction::LOWEST);
+        table.addPlayer("B", h1, Table::Direction::HIGHEST);
+        table.addPlayer("C", h2, Table::Direction::LOWEST);
+        assert(!table.setTurnOrder({0, 0}));
+        assert(!table.setTurnOrder({3}));
+        assert(table.setTurnOrder({2, 1, 0}));
+        vector<Table::Pick> picks;
+        table.play(picks);
+        // C takes c2 from A (next holder after C), B then takes c3 from C,
+        // and B's c2 no longer matches anyone
+        assert(picks.size() == 2);
+        assert(picks[0].picker == 2 && picks[0].from == 0 && picks[0].card == Card('c','2'));
+        assert(picks[1].picker == 1 && picks[1].from == 2 && picks[1].card == Card('c','3'));
+        assert(seq_inorder(table.hand(0)) == vector<Card>{Card('h','k')});
+        assert(seq_inorder(table.hand(1)) == vector<Card>{Card('c','2')});
+        assert(table.hand(2).size() == 0);
+
+        Table full;
+        for (size_t i = 0; i < Table::MAX_PLAYERS; ++i) assert(full.addPlayer("P", CardList(), Table::Direction::LOWEST));
+        assert(!full.addPlayer("P", CardList(), Table::Direction::LOWEST));
+    }
+    cout << "Table tests passed." << endl;
+
+    // ===== 11) Lazy deletion (tombstones + compaction) =====
+    {
+        CardList t;
+        t.setLazyDelete(true, 0.5);
+        for (int i : {20, 10, 30, 5, 15, 25, 35, 1}) t.insert(cardFromIndex(i));
+
+        t.remove(cardFromIndex(10));   // two children: just marked dead
+        t.remove(cardFromIndex(1));
+        assert(t.tombstones() == 2 && t.size() == 6);
+        assert(!t.contains(cardFromIndex(10)) && t.contains(cardFromIndex(15)));
+        vector<Card> expected;
+        for (int i : {5, 15, 20, 25, 30, 35}) expected.push_back(cardFromIndex(i));
+        assert(seq_inorder(t) == expected);
+        vector<Card> rev(expected.rbegin(), expected.rend());
+        assert(seq_reverse(t) == rev);
+        assert(print_to_string(t).find("c 10") == string::npos);
+
+        // removing a dead card again is a no-op; re-inserting revives it
+        t.remove(cardFromIndex(10));
+        assert(t.tombstones() == 2);
+        t.insert(cardFromIndex(10));
+        assert(t.contains(cardFromIndex(10)) && t.tombstones() == 1 && t.size() == 7);
+
+        // dead ends are skipped by begin()/rbegin()
+        t.remove(cardFromIndex(5));
+        t.remove(cardFromIndex(35));
+        assert(*t.begin() == cardFromIndex(10) && *t.rbegin() == cardFromIndex(30));
+
+        // crossing the threshold compacts every tombstone
+        t.remove(cardFromIndex(20));
+        t.remove(cardFromIndex(25));
+        assert(t.tombstones() == 0 && t.size() == 3);
+        expected = { cardFromIndex(10), cardFromIndex(15), cardFromIndex(30) };
+        assert(seq_inorder(t) == expected);
+
+        // copies and set algebra see only live cards
+        t.remove(cardFromIndex(15));
+        CardList copy = t;
+        assert(!copy.contains(cardFromIndex(15)) && copy.size() == 2);
+        CardList all;
+        all.insert(cardFromIndex(15));
+        assert(t.set_intersection(all).size() == 0);
+        t.set_union_with(all);
+        assert(t.tombstones() == 0 && t.size() == 3 && t.contains(cardFromIndex(15)));
+
+        // switching lazy deletion off compacts and restores eager removal
+        t.remove(cardFromIndex(30));
+        assert(t.tombstones() == 1);
+        t.setLazyDelete(false);
+        assert(t.tombstones() == 0 && t.size() == 2);
+        t.remove(cardFromIndex(10));
+        assert(t.tombstones() == 0 && t.size() == 1);
+
+        // the game gives the same result with lazy hands
+        CardList a1, b1;
+        for (int i = 0; i < 52; i += 2) a1.insert(cardFromIndex(i));
+        for (int i = 0; i < 52; i += 3) b1.insert(cardFromIndex(i));
+        CardList a2 = a1, b2 = b1;
+        a2.setLazyDelete(true);
+        b2.setLazyDelete(true);
+        vector<Card> m1, m2;
+        playGame(a1, b1, m1);
+        playGame(a2, b2, m2);
+        assert(m1 == m2 && seq_inorder(a1) == seq_inorder(a2) && seq_inorder(b1) == seq_inorder(b2));
+    }
+    cout << "Lazy deletion tests passed." << endl;
+
+    // ===== 12) find / erase / hinted insert =====
+    {
+        CardList t;
+        for (int i : {20, 10, 30, 5, 15, 25, 35}) t.insert(cardFromIndex(i));
+        assert(t.find(cardFromIndex(7)) == t.end());
+        CardList::iterator it = t.find(cardFromIndex(20));
+        assert(it != t.end() && *it == cardFromIndex(20));
+
+        // erase the root (two children) and a leaf; erase returns the successor
+        it = t.erase(it);
+        assert(*it == cardFromIndex(25) && !t.contains(cardFromIndex(20)));
+        it = t.erase(t.find(cardFromIndex(35)));
+        assert(it == t.end() && t.size() == 5);
+        vector<Card> expected;
+        for (int i : {5, 10, 15, 25, 30}) expected.push_back(cardFromIndex(i));
+        assert(seq_inorder(t) == expected);
+        vector<Card> rev(expected.rbegin(), expected.rend());
+        assert(seq_reverse(t) == rev);
+
+        // erase every card front to back
+        for (it = t.begin(); it != t.end(); ) it = t.erase(it);
+        assert(t.size() == 0 && t.begin() == t.end());
+
+        // hinted insert: ascending, descending, and wrong hints all give a sorted list
+        CardList up, down, wrong;
+        CardList::iterator h = up.end();
+        for (int i = 0; i < 52; ++i) h = up.insert(h, cardFromIndex(i));
+        h = down.end();
+        for (int i = 51; i >= 0; --i) h = down.insert(h, cardFromIndex(i));
+        h = wrong.end();
+        for (int i : {30, 2, 40, 7, 51, 0, 29}) h = wrong.insert(h, cardFromIndex(i));
+        assert(up.size() == 52 && seq_inorder(up) == seq_inorder(down));
+        // sorted loads never walk: each hint is the current largest/smallest node
+        assert(up.hintWalks() == 0 && down.hintWalks() == 0);
+        CardList prepend;
+        for (int i = 51; i >= 0; --i) prepend.insert(prepend.begin(), cardFromIndex(i));
+        assert(prepend.hintWalks() == 0 && seq_inorder(prepend) == seq_inorder(up));
+        vector<Card> got = seq_inorder(wrong);
+        assert(got.size() == 7 && is_sorted(got.begin(), got.end()) && wrong.hintWalks() == 5);
+        h = wrong.insert(wrong.find(cardFromIndex(30)), cardFromIndex(30));
+        assert(*h == cardFromIndex(30) && wrong.size() == 7);
+        assert(*up.insert(up.find(cardFromIndex(9)), cardFromIndex(9)) == cardFromIndex(9));
+
+        // erase in lazy mode leaves tombstones that iteration skips
+        CardList lazy = up;
+        lazy.setLazyDelete(true, 0.9);
+        it = lazy.erase(lazy.find(cardFromIndex(10)));
+        assert(*it == cardFromIndex(11) && lazy.tombstones() == 1);
+        it = lazy.insert(lazy.find(cardFromIndex(11)), cardFromIndex(10));
+        assert(*it == cardFromIndex(10) && lazy.tombstones() == 0 && lazy.size() == 52);
+
+        // playGame on synthetic deals matches a rescan-from-the-ends reference
+        for (int n = 0; n < 4; ++n) {
+            CardList a, b;
+            for (int i = 0; i < 52; ++i) {
+                if ((i * 7 + n) % 3 != 0) a.insert(cardFromIndex(i));
+                if ((i * 5 + n) % 4 != 0) b.insert(cardFromIndex(i));
+            }
+            CardList a2 = a, b2 = b;
+            vector<Card> moves;
+            playGame(a, b, moves);
+            // reference: restart both scans from the ends on every turn
+            vector<Card> ref;
+            while (true) {
+                bool found = false;
+                for (auto x = a2.begin(); x != a2.end(); ++x) {
+                    if (b2.contains(*x)) { Card c = *x; ref.push_back(c); a2.remove(c); b2.remove(c); found = true; break; }
+                }
+                if (!found) break;
+                found = false;
+                for (auto x = b2.rbegin(); x != b2.rend(); --x) {
+                    if (a2.contains(*x)) { Card c = *x; ref.push_back(c); a2.remove(c); b2.remove(c); found = true; break; }
+                }
+                if (!found) break;
+            }
+            assert(moves == ref && seq_inorder(a) == seq_inorder(a2) && seq_inorder(b) == seq_inorder(b2));
+        }
+    }
+    cout << "find/erase/hinted insert tests passed." << endl;
+
+    // ===== 13) Tracing =====
+    {
+        { trace::Span off("not recorded"); } // tracing still disabled
+        trace::start();
+        {
+            trace::Span outer("outer");
+            trace::Span inner("inner \"quoted\"");
+        }
+        std::thread worker([] { trace::Span span("worker"); });
+        worker.join();
+        CardList a, b;
+        a.insert(Card('c','a'));
+        b.insert(Card('c','a'));
+        playGame(a, b); // records one Alice turn and one Bob turn
+
+        const char* path = "test_trace.json";
+        assert(trace::writeJson(path));
+        std::ifstream in(path);
+        string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        assert(json.find("not recorded") == string::npos);
+        assert(json.find("\"name\":\"outer\"") != string::npos);
+        assert(json.find("inner \\\"quoted\\\"") != string::npos);
+        assert(json.find("\"Alice turn\"") != string::npos && json.find("\"Bob turn\"") != string::npos);
+        // the worker thread got its own ring and thread id
+        assert(json.find("\"name\":\"worker\",\"ph\":\"X\",\"pid\":1,\"tid\":2") != string::npos);
+        std::remove(path);
+        trace::enabled = false;
+    }
+    cout << "Tracing tests passed." << endl;
+
+    // ===== 14) File-backed DiskCardList =====
+    {
+        const char* path = "test_disk_cards.bpt";
+        std::remove(path);
+        vector<Card> deck;
+        for (int i = 0; i < 52; ++i) deck.push_back(cardFromIndex((i * 17) % 52)); // scrambled order
+        {
+            // tiny pages and cache so the tree splits and evicts
+            DiskCardList disk(path, 4, 64);
+            assert(!disk.fail());
+            assert(disk.begin() == disk.end() && disk.size() == 0);
+            for (const Card& c : deck) disk.insert(c);
+            disk.insert(deck[0]); // duplicate ignored
+            assert(disk.size() == 52);
+            int index = 0;
+            for (DiskCardList::iterator it = disk.begin(); it != disk.end(); ++it) {
+                assert(*it == cardFromIndex(index++));
+            }
+            assert(index == 52);
+            DiskCardList::iterator it = disk.rbegin();
+            for (index = 51; it != disk.rend(); --it) assert(*it == cardFromIndex(index--));
+            assert(index == -1);
+            assert(*--disk.end() == Card('h','k'));
+
+            // empty out whole leaves; iteration skips them
+            for (int i = 0; i < 40; ++i) disk.remove(cardFromIndex(i));
+            disk.remove(cardFromIndex(0)); // already gone
+            assert(disk.size() == 12);
+            assert(!disk.contains(cardFromIndex(5)) && disk.contains(cardFromIndex(45)));
+            assert(*disk.begin() == cardFromIndex(40));
+        }
+        {
+            // reopen: only the header is read; pageSize comes from the file
+            DiskCardList disk(path);
+            assert(!disk.fail() && disk.size() == 12);
+            int index = 40;
+            for (const Card& c : disk) assert(c == cardFromIndex(index++));
+            assert(index == 52);
+            disk.insert(cardFromIndex(0));
+            assert(*disk.begin() == Card('c','a'));
+        }
+        {
+            // a damaged first leaf is caught when it is read, not trusted
+            {
+                std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+                file.seekp(64); // page 1 of the 64-byte pages: the first leaf
+                file.put(char(0x7f)).put(0).put(char(0xff)).put(char(0xff));
+            }
+            DiskCardList damaged(path);
+            assert(!damaged.fail());
+            assert(damaged.begin() == damaged.end() && damaged.fail());
+            assert(!damaged.contains(cardFromIndex(45)) && !damaged.flush());
+        }
+        {
+            // cut back to the header: the pages it names are gone
+            std::filesystem::resize_file(path, 64);
+            DiskCardList truncated(path);
+            assert(truncated.fail() && !truncated.contains(cardFromIndex(45)));
+        }
+        {
+            std::ofstream junk(path);
+            junk << "not a card list";
+        }
+        DiskCardList bad(path);
+        assert(bad.fail() && bad.begin() == bad.end());
+        std::remove(path);
+
+        // a failed write is reported rather than dropped
+        if (std::ifstream("/dev/full")) {
+            DiskCardList full("/dev/full");
+            assert(full.fail() && !full.flush());
+        }
+    }
+    cout << "DiskCardList tests passed." << endl;
+
+    // ===== 15) SplayCardList =====
+    {
+        SplayCardList hand;
+        assert(hand.begin() == hand.end() && !hand.contains(Card('c','a')));
+        SplayCardList::iterator hint = hand.end();
+        for (int i = 0; i < 52; i += 2) hint = hand.insert(hint, cardFromIndex(i)); // sorted append
+        hand.insert(cardFromIndex(7));
+        hand.insert(cardFromIndex(7)); // duplicate ignored
+        assert(hand.size() == 27);
+        assert(hand.contains(cardFromIndex(7)) && !hand.contains(cardFromIndex(9)));
+
+        // lookups restructure the tree but iterators keep their cards
+        SplayCardList::iterator it = hand.find(cardFromIndex(20));
+        assert(it != hand.end() && *it == cardFromIndex(20));
+        for (int i = 0; i < 52; ++i) hand.contains(cardFromIndex(i));
+        assert(*it == cardFromIndex(20) && *++it == cardFromIndex(22));
+        vector<Card> seq;
+        for (const Card& c : hand) seq.push_back(c);
+        assert(seq.size() == 27 && std::is_sorted(seq.begin(), seq.end()));
+        assert(*hand.rbegin() == cardFromIndex(50) && *--hand.end() == cardFromIndex(50));
+
+        it = hand.erase(hand.find(cardFromIndex(7)));
+        assert(*it == cardFromIndex(8) && hand.size() == 26);
+        hand.remove(cardFromIndex(0));
+        hand.remove(cardFromIndex(1)); // not held
+        assert(*hand.begin() == cardFromIndex(2) && hand.size() == 25);
+
+        SplayCardList copy(hand);
+        copy.remove(cardFromIndex(2));
+        assert(hand.contains(cardFromIndex(2)) && !copy.contains(cardFromIndex(2)));
+        SplayCardList moved(std::move(copy));
+        assert(moved.size() == 24 && copy.size() == 0);
+        std::ostringstream os;
+        SplayCardList small;
+        small.insert(Card('h','k'));
+        small.insert(Card('c','a'));
+        small.print(os);
+        assert(os.str() == " c a h k");
+
+        // same picks as CardList on a run of pseudo-random deals
+        uint64_t state = 12345;
+        for (int deal = 0; deal < 200; ++deal) {
+            CardList a, b;
+            SplayCardList sa, sb;
+            for (int i = 0; i < 52; ++i) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                int idx = (i * 23 + deal) % 52; // scrambled insertion order
+                if (state >> 62 & 1) { a.insert(cardFromIndex(idx)); sa.insert(cardFromIndex(idx)); }
+                if (state >> 63) { b.insert(cardFromIndex(idx)); sb.insert(cardFromIndex(idx)); }
+            }
+            vector<Card> expected, actual;
+            playGame(a, b, expected);
+            playGame(sa, sb, actual);
+            assert(expected == actual);
+            vector<Card> left, sleft;
+            for (const Card& c : a) left.push_back(c);
+            for (const Card& c : sa) sleft.push_back(c);
+            assert(left == sleft && b.size() == sb.size());
+        }
+    }
+    cout << "SplayCardList tests passed." << endl;
+
+    // ===== 16) Lane-parallel deal kernel =====
+    {
+        // 203 deals: not a multiple of any lane count, with empty, disjoint,
+        // identical and full hands mixed in
+        vector<uint64_t> alice, bob;
+        alice.push_back(0); bob.push_back(0);
+        alice.push_back(DECK_MASK); bob.push_back(DECK_MASK);
+        alice.push_back(0x5555555555555ULL); bob.push_back(0xAAAAAAAAAAAAAULL);
+        uint64_t state = 99;
+        while (alice.size() < 203) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            uint64_t a = state >> 12;
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            alice.push_back(a);
+            bob.push_back(alice.size() % 7 == 0 ? a : state >> 12);
+        }
+        alice.push_back(DECK_MASK | (uint64_t(1) << 60)); // bits above the deck are ignored
+        bob.push_back(DECK_MASK);
+
+        vector<Outcome> expected(alice.size());
+        for (size_t i = 0; i < alice.size(); ++i) {
+            CardList a, b;
+            fromMask(a, alice[i]);
+            fromMask(b, bob[i]);
+            vector<Card> moves;
+            playGame(a, b, moves);
+            expected[i].moveCount = static_cast<uint8_t>(moves.size());
+            for (size_t m = 0; m < moves.size(); ++m) expected[i].moves[m] = static_cast<uint8_t>(cardIndex(moves[m]));
+            assert(toMask(a, expected[i].alice) && toMask(b, expected[i].bob));
+        }
+
+        for (deal::Kernel kernel : {deal::Kernel::SCALAR, deal::Kernel::AVX2, deal::Kernel::AVX512}) {
+            // unsupported kernels fall back to the scalar one, so run them all
+            vector<Outcome> got(alice.size());
+            deal::playDeals(kernel, alice.data(), bob.data(), alice.size(), got.data());
+            for (size_t i = 0; i < alice.size(); ++i) {
+                assert(got[i].moveCount == expected[i].moveCount);
+                assert(std::equal(got[i].moves, got[i].moves + got[i].moveCount, expected[i].moves));
+                assert(got[i].alice == expected[i].alice && got[i].bob == expected[i].bob);
+            }
+            deal::playDeals(kernel, alice.data(), bob.data(), 0, got.data()); // no deals: no-op
+        }
+        assert(deal::supported(deal::Kernel::SCALAR) && deal::supported(deal::best()));
+        cout << "deal kernel: " << deal::name(deal::best()) << endl;
+    }
+    cout << "Deal kernel tests passed." << endl;
+
+    // ===== 17) Batched interleaved lookups =====
+    {
+        // a degenerate chain of 100 even keys
+        struct Node { int key; Node* left; Node* right; };
+        vector<Node> chain(100);
+        for (int i = 0; i < 100; ++i) chain[i] = Node{2 * i, nullptr, i + 1 < 100 ? &chain[i + 1] : nullptr};
+        vector<int> keys;
+        for (int k = -3; k < 205; ++k) keys.push_back(k);
+        std::unique_ptr<bool[]> hits(new bool[keys.size()]);
+        auto visit = [](const Node* node, int key, bool& hit) -> const Node* {
+            if (key == node->key) {
+                hit = true;
+                return nullptr;
+            }
+            const Node* child = key < node->key ? node->left : node->right;
+            if (child == nullptr) hit = false;
+            return child;
+        };
+        probeInterleaved<8>(&chain[0], keys.data(), keys.size(), hits.get(), visit);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            assert(hits[i] == (keys[i] >= 0 && keys[i] < 200 && keys[i] % 2 == 0));
+        }
+        probeInterleaved<4>(static_cast<const Node*>(nullptr), keys.data(), 3, hits.get(), visit);
+        assert(!hits[0] && !hits[1] && !hits[2]);
+    }
+    cout << "Batched lookup tests passed." << endl;
+
     cout << "\nALL tests passed successfully." << endl;
     return 0;
 }
@@ -0,0 +1,117 @@
+// trace.cpp
+// Author: Owen Kirchner
+// Implementation of the tracing facility declared in trace.h
+
+#include "trace.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace trace {
+
+std::atomic<bool> enabled{false};
+
+namespace {
+
+constexpr std::size_t RING_SIZE = 1 << 16; // spans kept per thread
+
+struct Event {
+    const char* name;
+    std::uint64_t begin;
+    std::uint64_t end;
+};
+
+// single producer (the owning thread); read by writeJson
+struct Ring {
+    std::uint32_t tid = 0;
+    std::atomic<std::uint64_t> head{0};
+    Event events[RING_SIZE];
+};
+
+std::chrono::steady_clock::time_point epoch;
+std::mutex registryLock; // taken once per thread, when its ring is created
+std::vector<std::unique_ptr<Ring>> rings;
+thread_local Ring* threadRing = nullptr;
+
+Ring* ringForThisThread() {
+    if (threadRing == nullptr) {
+        auto ring = std::make_unique<Ring>();
+        std::lock_guard<std::mutex> guard(registryLock);
+        ring->tid = static_cast<std::uint32_t>(rings.size() + 1);
+        threadRing = ring.get();
+        rings.push_back(std::move(ring));
+    }
+    return threadRing;
+}
+
+// Chrome wants microseconds; keep the nanosecond digits as a fraction
+void writeMicros(std::ostream& os, std::uint64_t ns) {
+    os << ns / 1000 << '.';
+    std::uint64_t frac = ns % 1000;
+    if (frac < 100) os << '0';
+    if (frac < 10) os << '0';
+    os << frac;
+}
+
+void writeString(std::ostream& os, const char* s) {
+    os << '"';
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') os << '\\';
+        os << *s;
+    }
+    os << '"';
+}
+
+} // namespace
+
+void start() {
+    epoch = std::chrono::steady_clock::now();
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+std::uint64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void record(const char* name, std::uint64_t begin, std::uint64_t end) {
+    Ring* ring = ringForThisThread();
+    std::uint64_t head = ring->head.load(std::memory_order_relaxed);
+    ring->events[head % RING_SIZE] = Event{name, begin, end};
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+bool writeJson(const std::string& path) {
+    std::ofstream os(path);
+    if (!os) return false;
+
+    std::lock_guard<std::mutex> guard(registryLock);
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& ring : rings) {
+        os << (first ? "\n" : ",\n");
+        first = false;
+        os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->tid
+           << ",\"args\":{\"name\":\"thread " << ring->tid << "\"}}";
+
+        std::uint64_t head = ring->head.load(std::memory_order_acquire);
+        std::uint64_t oldest = head > RING_SIZE ? head - RING_SIZE : 0;
+        for (std::uint64_t i = oldest; i < head; ++i) {
+            const Event& e = ring->events[i % RING_SIZE];
+            os << ",\n{\"name\":";
+            writeString(os, e.name);
+            os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->tid << ",\"ts\":";
+            writeMicros(os, e.begin);
+            os << ",\"dur\":";
+            writeMicros(os, e.end - e.begin);
+            os << '}';
+        }
+    }
+    os << "\n]}\n";
+    return static_cast<bool>(os);
+}
+
+} // namespace trace